@@ -10,6 +10,8 @@
 #include "errors.h"
 #include "parameters.h"
 #include "localSearch.h"
+#include "store.h"
+#include "checkpoint.h"
 
 using namespace std;
 
@@ -51,7 +53,7 @@ void initPheromones(vector<vector<double>> & pheromones, int & bestWCTInit) {
  * @param[in] bestWCTever Self explanatory
  * @param[in] target Quality solution that the algorithm wants to reach
  * @param[in] timeLimit in ms
- * @param[out] termination True if the algorithm should stop, false otherwise
+ * @param[out] termination True if the algorithm should stop (including when the evaluation budget, the deadline or a cancellation stopped the search, or when the gap to the lower bound is small enough), false otherwise
  * @return false if one error occured, true otherwise
  */
 bool updateTermination(int & iteration, int & max_iterations, chrono::duration<double, std::milli> & ms_double, int bestWCTever, int & target, double & timeLimit, bool & termination) {
@@ -70,7 +72,13 @@ bool updateTermination(int & iteration, int & max_iterations, chrono::duration<d
     if (bestWCTever <= target) {
         termination = true;
     }
-    if (ms_double.count() > timeLimit){
+    if (runTime(ms_double.count()) > timeLimit){
+        termination = true;
+    }
+    if (stopRequested()) {
+        termination = true;
+    }
+    if (gapReached(bestWCTever)) {
         termination = true;
     }
     return true;
@@ -87,6 +95,7 @@ bool updateTermination(int & iteration, int & max_iterations, chrono::duration<d
  * @return false if one error occured, true otherwise
  */
 bool updatePheromones(vector<int> & bestSolEver, vector<vector<int>> & antSolution, vector<int> & antWCT, double & rho, vector<vector<double>> & pheromones) {
+    ScopedPhase phase("updatePheromones");
     int jobAnt;
     double diffJobAnt;
     int oldPlaceJob;
@@ -124,6 +133,7 @@ bool updatePheromones(vector<int> & bestSolEver, vector<vector<int>> & antSoluti
 /**
  * Construct a new solution, using the matrix of pheromones and the best solution found so far
  * The pseudo-code of this function is presented in the report
+ * Once stopRequested(), the construction is completed by copying the order of bestSolEver
  * 
  * @param[in] pheromones matrix of pheromones
  * @param[in] bestSolEver best solution found so far
@@ -133,6 +143,8 @@ bool updatePheromones(vector<int> & bestSolEver, vector<vector<int>> & antSoluti
  * @return false if one error occured, true otherwise
  */
 bool constructSolution(vector<vector<double>> & pheromones, vector<int> bestSolEver, int & ant, vector<vector<int>> & antSolution, vector<int> & antWCT) {
+    ScopedPhase phase("constructSolution");
+    ScopedLatency latency(constructionLatency);
     /// random numbers
     double randomDouble;
     double randomDouble_2;
@@ -155,7 +167,12 @@ bool constructSolution(vector<vector<double>> & pheromones, vector<int> bestSolE
     double sum;
     
     for (int indexJob = 1; indexJob <= instance.getNbJob(); indexJob++) {
-        randomDouble = (double) rand() / (RAND_MAX);
+        if (stopRequested()) {
+            /// no time left : the remaining positions are filled following bestSolEver
+            randomDouble = 0.;
+        } else {
+            randomDouble = (double) randomInt() / (RAND_MAX);
+        }
         if (randomDouble < 0 || randomDouble > 1) {
             generateError("aco.h","constructSolution","randomDouble out of range","randomDouble",randomDouble);
             return false;
@@ -213,7 +230,7 @@ bool constructSolution(vector<vector<double>> & pheromones, vector<int> bestSolE
                 /// we already chose the job, we just have to signal that it is scheduled now
                 bestSolEver[indexChosenJob] = 0;
             } else {
-                randomDouble_2 = (double) rand() / (RAND_MAX);
+                randomDouble_2 = (double) randomInt() / (RAND_MAX);
 
                 if (randomDouble < 0 || randomDouble > 1) {
                     generateError("aco.h","constructSolution","randomDouble_2 out of range","randomDouble_2",randomDouble_2);
@@ -237,7 +254,8 @@ bool constructSolution(vector<vector<double>> & pheromones, vector<int> bestSolE
         }
         antSolution[ant][indexJob] = chosenJob;
     }
-    instance.computeWCT(instance.getNbJob(), antSolution[ant], antWCT[ant]);
+    Objective::evaluate(instance.getNbJob(), antSolution[ant], antWCT[ant]);
+    STAT_INC(constructions);
     return true;
 }
 
@@ -247,11 +265,14 @@ bool constructSolution(vector<vector<double>> & pheromones, vector<int> bestSolE
  * @param[in,out] pheromones the matrix of pheromones
  */
 void disturbPheromones(vector<vector<double>> & pheromones) {
+    ScopedPhase phase("disturbPheromones");
     double randomDouble;
     double maxPhi = 0;
     double alpha = 0.2;
     double beta = 0.8;
 
+    STAT_INC(disturbances);
+
     // compute the maximum level of pheromones
     for (int i = 1; i <= instance.getNbJob(); i++) {
         for (int j= 1; j <= instance.getNbJob(); j++) {
@@ -267,9 +288,9 @@ void disturbPheromones(vector<vector<double>> & pheromones) {
     // randomize the matrix of pheromones
     for (int i = 1; i <= instance.getNbJob(); i++) {
         for (int j= 1; j <= instance.getNbJob(); j++) {
-            randomDouble = (double) rand() / (RAND_MAX);
+            randomDouble = (double) randomInt() / (RAND_MAX);
             if (randomDouble <= 1) {
-                randomDouble = ((double) rand() / (RAND_MAX))*maxPhi;
+                randomDouble = ((double) randomInt() / (RAND_MAX))*maxPhi;
                 pheromones[i][j] = randomDouble*alpha+pheromones[i][j]*beta;
             }
         }
@@ -304,21 +325,85 @@ bool ACO_heuristic(bool & readParams, int & target, double & timeLimit) {
         setDefaultParameters(rho,max_iterations);
     }
 
-    resizeMatrix(pheromones,antSolution,antWCT,bestSolEver);
+    Checkpoint checkpoint;
+    bool resumed = false;
+    bool checkpointing = !checkpoint_file.empty();
+    if (!loadCheckpoint("ACO",checkpoint,resumed)) { return false; }
 
-    // INITIAL SOLUTION
-    simplifiedRZ(bestSolEver,bestWCTEver);
-    embeddedVND(bestSolEver,bestWCTEver);
-
-    // INIT PHEROMONES
-    initPheromones(pheromones,bestWCTEver);
+    resizeMatrix(pheromones,antSolution,antWCT,bestSolEver);
+    startBudget(timeLimit);
+    resetStats();
+    resetLatencies();
 
     bool termination = false;
     int iteration = 1;
     int lastWCT = 0;
     int stagnate = 0;
+    double timeToBest;
+
+    if (resumed) {
+        // STATE OF THE CHECKPOINT
+        bestSolEver = checkpoint.bestSol;
+        bestWCTEver = checkpoint.bestWCT;
+        pheromones = checkpoint.pheromones;
+        iteration = checkpoint.iteration;
+        lastWCT = checkpoint.lastWCT;
+        stagnate = checkpoint.stagnate;
+        timeToBest = checkpoint.timeToBest;
+        restoreRandom(checkpoint.random);
+        resumeBudget(checkpoint.wallTime,checkpoint.cpuTime,checkpoint.evaluations);
+        start -= chrono::duration_cast<chrono::high_resolution_clock::duration>(chrono::duration<double, std::milli>(checkpoint.wallTime));
+        startTrace();
+        recordImprovement(timeToBest,iteration,bestWCTEver);
+    } else {
+        // INITIAL SOLUTION
+        if (!initialSolution(bestSolEver,bestWCTEver)) { return false; }
+
+        end = chrono::high_resolution_clock::now();
+        ms_double = end - start;
+        timeToBest = runTime(ms_double.count());
+        startTrace();
+        recordImprovement(timeToBest,0,bestWCTEver);
+
+        // INIT PHEROMONES
+        initPheromones(pheromones,bestWCTEver);
+    }
 
     while (!termination) {
+        ScopedLatency latency(iterationLatency);
+
+        if (!edits_file.empty()) {
+            // REPAIR AFTER EDITS OF THE INSTANCE
+            vector<int> jobMap;
+            vector<int> addedJobs;
+            bool edited;
+            if (!pollEdits(jobMap,addedJobs,edited)) { return false; }
+            if (edited) {
+                if (!repairSolution(bestSolEver,bestWCTEver,jobMap,addedJobs)) { return false; }
+                repairPheromones(pheromones,jobMap,bestWCTEver);
+                antSolution[1].resize(instance.getNbJob()+1);
+                lastWCT = 0;
+                stagnate = 0;
+                if (!quiet) {
+                    cout << "repaired best : WCT -> " << bestWCTEver << ", it : " << iteration << '\n';
+                }
+            }
+        }
+
+        if (checkpointing && checkpointDue(checkpoint)) {
+            ms_double = chrono::high_resolution_clock::now() - start;
+            captureCheckpoint("ACO",ms_double.count(),timeToBest,checkpoint);
+            checkpoint.bestSol = bestSolEver;
+            checkpoint.bestWCT = bestWCTEver;
+            checkpoint.pheromones = pheromones;
+            checkpoint.iteration = iteration;
+            checkpoint.lastWCT = lastWCT;
+            checkpoint.stagnate = stagnate;
+            checkpoint.temperature = 0.;
+            checkpoint.currentSol.assign(1,0);
+            checkpoint.currentWCT = 0;
+            if (!periodicCheckpoint(checkpoint)) { return false; }
+        }
 
         for (int ant = 1; ant <= 1; ant ++) {
 
@@ -345,7 +430,11 @@ bool ACO_heuristic(bool & readParams, int & target, double & timeLimit) {
                 replaceSolByNewSol(bestSolEver,antSolution[ant]);
                 end = chrono::high_resolution_clock::now();
                 ms_double = end - start;
-                cout << "new best : WCT -> "<< bestWCTEver << ", time : " << ms_double.count()/1000 << "s, it : " << iteration << endl;
+                timeToBest = runTime(ms_double.count());
+                recordImprovement(timeToBest,iteration,bestWCTEver);
+                if (!quiet) {
+                    cout << "new best : WCT -> "<< bestWCTEver << ", time : " << ms_double.count()/1000 << "s, it : " << iteration << ", evaluations : " << instance.getNbEvaluations() << ", gap : " << formatGap(bestWCTEver) << '\n';
+                }
             }
 
             // Update pheromones
@@ -361,6 +450,22 @@ bool ACO_heuristic(bool & readParams, int & target, double & timeLimit) {
         if (!updateTermination(iteration, max_iterations, ms_double, bestWCTEver, target, timeLimit, termination)) { return false; }
     }
 
+    if (checkpointing && !finishCheckpoint(checkpoint)) { return false; }
+
+    end = chrono::high_resolution_clock::now();
+    ms_double = end - start;
+    saveRunResult(bestSolEver,bestWCTEver,timeToBest,ms_double.count());
+    if (!stats_format.empty()) {
+        printStats(ms_double.count());
+    }
+    if (latency_report) {
+        printLatencies("run",vndLatency,iterationLatency,constructionLatency);
+    }
+
+    if (!quiet) {
+        cout << "best : WCT -> " << bestWCTEver << ", lower bound : " << lowerBound << ", gap : " << formatGap(bestWCTEver) << ", wall time : " << lastRun.time/1000. << "s, cpu time : " << lastRun.cpuTime/1000. << "s" << endl;
+    }
+
     return true;
 }
 
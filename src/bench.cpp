@@ -0,0 +1,218 @@
+/*****************************************************************************
+ * Microbenchmarks of the evaluation and neighborhood kernels (make bench)   *
+ *****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+#include "localSearch.h"
+#include "aco.h"
+#include "generator.h"
+
+using namespace std;
+
+int bench_warmup = 3; /// untimed repetitions before the measures
+int bench_repetitions = 15; /// timed repetitions, the median is reported
+string bench_filter = ""; /// only the benchmarks whose name contains this string are run
+
+/**
+ * Fill the global instance with a generated instance (Taillard-style uniform times, see generator.h)
+ *
+ * @param[in] nbJobs Number of jobs
+ * @param[in] nbMachines Number of machines
+ * @param[in] instanceSeed Seed of the generator, the same seed gives the same instance
+ */
+void fillBenchInstance(int nbJobs, int nbMachines, unsigned int instanceSeed)
+{
+    GeneratorParameters parameters;
+    parameters.nbJobs = nbJobs;
+    parameters.nbMachines = nbMachines;
+    parameters.generatorSeed = instanceSeed;
+    generateInstance(parameters);
+}
+
+/**
+ * Time a kernel : bench_warmup untimed calls, then bench_repetitions timed calls
+ *
+ * @param[in] name Name of the benchmark, printed in the report
+ * @param[in] setup Called before each call of the kernel, not timed (restores the input of the kernel)
+ * @param[in] kernel The kernel, returns false if one error occured
+ * @return false if one error occured, true otherwise
+ */
+template <typename Setup, typename Kernel>
+bool runBenchmark(string name, Setup setup, Kernel kernel)
+{
+    if (!bench_filter.empty() && name.find(bench_filter) == string::npos) {
+        return true;
+    }
+    vector<double> times; /// ns per call
+    vector<double> evaluations; /// work units per call
+    for (int r = 0; r < bench_warmup + bench_repetitions; r++) {
+        setup();
+        startBudget(0);
+        auto begin = chrono::steady_clock::now();
+        if (!kernel()) {
+            generateError("bench.cpp","runBenchmark","the kernel failed");
+            return false;
+        }
+        auto end = chrono::steady_clock::now();
+        if (r >= bench_warmup) {
+            times.push_back(chrono::duration<double, std::nano>(end - begin).count());
+            evaluations.push_back(instance.getNbEvaluations());
+        }
+    }
+    sort(times.begin(),times.end());
+    double median = times[times.size()/2];
+    double evaluationsPerCall = evaluations[0];
+    cout << left << setw(40) << name << right << fixed << setprecision(0)
+         << setw(14) << median << setw(14) << times[0]
+         << setw(12) << setprecision(1) << evaluationsPerCall;
+    if (evaluationsPerCall > 0) {
+        cout << setw(14) << setprecision(1) << median/evaluationsPerCall;
+    } else {
+        cout << setw(14) << "-";
+    }
+    cout << defaultfloat << setprecision(6) << "\n";
+    return true;
+}
+
+/**
+ * Benchmark computeWCT (through the objective) on a random permutation
+ */
+bool benchEvaluation(int nbJobs, int nbMachines)
+{
+    fillBenchInstance(nbJobs,nbMachines,1);
+    if (!randomPermutation()) { return false; }
+    vector<int> sol (solution);
+    int value = 0;
+    int nbCalls = 1000000 / (nbJobs * nbMachines) + 1;
+    string name = "evaluate " + to_string(nbJobs) + "x" + to_string(nbMachines) + " (x" + to_string(nbCalls) + ")";
+    return runBenchmark(name, []() {}, [&]() {
+        for (int c = 0; c < nbCalls; c++) {
+            if (!Objective::evaluate(nbJobs,sol,value)) { return false; }
+        }
+        return true;
+    });
+}
+
+/**
+ * Benchmark one full pass of each neighborhood under both pivoting rules
+ * The pass starts from a local optimum of the VND, so that first improvement scans the whole neighborhood too
+ */
+bool benchNeighborhoods(int nbJobs, int nbMachines)
+{
+    fillBenchInstance(nbJobs,nbMachines,2);
+    if (!randomPermutation()) { return false; }
+    vector<int> localOptimum (solution);
+    int localOptimumWCT = WCT;
+    if (!embeddedVND(localOptimum,localOptimumWCT)) { return false; }
+
+    vector<int> currentSol, bestSol;
+    int currentWCT, bestWCT;
+    bool improving;
+    string size = to_string(nbJobs) + "x" + to_string(nbMachines);
+    const char * neighborhoodNames[3] = {"transpose", "exchange", "insert"};
+    const char * ruleNames[2] = {"first", "best"};
+
+    for (int rule = 0; rule < 2; rule++) {
+        for (int n = 0; n < 3; n++) {
+            auto setup = [&]() {
+                pivoting_rule = rule == 0 ? First_improvement : Best_improvement;
+                solution = localOptimum;
+                WCT = localOptimumWCT;
+                currentSol = localOptimum;
+                bestSol = localOptimum;
+                currentWCT = localOptimumWCT;
+                bestWCT = localOptimumWCT;
+            };
+            auto kernel = [&]() {
+                if (n == 0) { return transpose(currentSol,currentWCT,bestSol,bestWCT,improving); }
+                if (n == 1) { return exchange(currentSol,currentWCT,bestSol,bestWCT,improving); }
+                return insert(currentSol,currentWCT,bestSol,bestWCT,improving);
+            };
+            string name = string(neighborhoodNames[n]) + " " + ruleNames[rule] + " " + size;
+            if (!runBenchmark(name,setup,kernel)) { return false; }
+        }
+    }
+    return true;
+}
+
+/**
+ * Benchmark the constructions : one insertion (constructSolMinWCT) and the whole simplifiedRZ
+ */
+bool benchConstructions(int nbJobs, int nbMachines)
+{
+    fillBenchInstance(nbJobs,nbMachines,3);
+    if (!randomPermutation()) { return false; }
+    vector<int> partial (solution);
+    vector<int> sol (solution);
+    int wct = 0;
+    string size = to_string(nbJobs) + "x" + to_string(nbMachines);
+
+    if (!runBenchmark("constructSolMinWCT " + size, [&]() { partial = solution; },
+            [&]() { return constructSolMinWCT(nbJobs-1,solution[nbJobs],partial); })) {
+        return false;
+    }
+    return runBenchmark("simplifiedRZ " + size, []() {}, [&]() { return simplifiedRZ(sol,wct); });
+}
+
+/**
+ * Benchmark the two steps of an ACO iteration : constructSolution and updatePheromones
+ */
+bool benchACO(int nbJobs, int nbMachines)
+{
+    fillBenchInstance(nbJobs,nbMachines,4);
+    vector<vector<double>> pheromones;
+    vector<vector<int>> antSolution;
+    vector<int> antWCT;
+    vector<int> bestSolEver;
+    int bestWCTEver;
+    double rho = 0.5;
+    int ant = 1;
+    resizeMatrix(pheromones,antSolution,antWCT,bestSolEver);
+    if (!simplifiedRZ(bestSolEver,bestWCTEver)) { return false; }
+    initPheromones(pheromones,bestWCTEver);
+    vector<vector<double>> initialPheromones (pheromones);
+    string size = to_string(nbJobs) + "x" + to_string(nbMachines);
+
+    if (!runBenchmark("constructSolution " + size, [&]() { seedRandom(5); },
+            [&]() { return constructSolution(pheromones,bestSolEver,ant,antSolution,antWCT); })) {
+        return false;
+    }
+    return runBenchmark("updatePheromones " + size, [&]() { pheromones = initialPheromones; },
+            [&]() { return updatePheromones(bestSolEver,antSolution,antWCT,rho,pheromones); });
+}
+
+int main(int argc, char * argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i],"--repetitions") == 0 && i+1 < argc) {
+            bench_repetitions = max(1,atoi(argv[++i]));
+        } else if (strcmp(argv[i],"--warmup") == 0 && i+1 < argc) {
+            bench_warmup = max(0,atoi(argv[++i]));
+        } else if (strcmp(argv[i],"--filter") == 0 && i+1 < argc) {
+            bench_filter = argv[++i];
+        } else {
+            cout << "usage : " << argv[0] << " [--repetitions <n>] [--warmup <n>] [--filter <substring>]" << endl;
+            return 1;
+        }
+    }
+    quiet = true;
+
+    cout << "objective : " << Objective::name() << ", " << bench_warmup << " warmup, " << bench_repetitions << " repetitions\n";
+    cout << left << setw(40) << "benchmark" << right << setw(14) << "median ns" << setw(14) << "min ns"
+         << setw(12) << "evals" << setw(14) << "ns/eval" << "\n";
+
+    int evaluationSizes[5][2] = {{20,5}, {50,20}, {100,20}, {500,20}, {2000,50}};
+    for (int k = 0; k < 5; k++) {
+        if (!benchEvaluation(evaluationSizes[k][0],evaluationSizes[k][1])) { return 1; }
+    }
+    if (!benchNeighborhoods(50,20) || !benchNeighborhoods(100,20)) { return 1; }
+    if (!benchConstructions(100,20) || !benchConstructions(200,20)) { return 1; }
+    if (!benchACO(100,20) || !benchACO(500,20)) { return 1; }
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*************************************************************
+ * Functions for handeling the computational budget of a run *
+ *************************************************************/
+
+#ifndef _BUDGET_H_
+#define _BUDGET_H_
+
+#include <chrono>
+#include <atomic>
+#include <time.h>
+
+#include "globalVariables.h"
+
+/// the clock is only read once every DEADLINE_CHECK_PERIOD calls of stopRequested
+#define DEADLINE_CHECK_PERIOD 16
+
+thread_local double runCPUStart = 0.; /// CPU time of the thread when the current run started, ms
+thread_local double runCPULimit = 0.; /// CPU time allowed to the current run with cpu_time, ms, 0 for no limit
+
+/**
+ * CPU time consumed by the calling thread (CLOCK_THREAD_CPUTIME_ID) : unlike the wall time, it doesn't grow
+ * while the thread waits for a core, so the runs sharing a machine are measured as if they were alone
+ * 
+ * @return the CPU time of the thread, ms
+ */
+double threadCPUTime()
+{
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1000. + now.tv_nsec / 1e6;
+}
+
+/**
+ * CPU time spent by the current run of the calling thread
+ * 
+ * @return ms since startBudget
+ */
+double runCPUTime()
+{
+    return threadCPUTime() - runCPUStart;
+}
+
+/**
+ * Time of the current run compared to its time limit : the CPU time of the thread with cpu_time, the given wall time otherwise
+ * 
+ * @param[in] wallTime Wall time since the start of the run, ms
+ * @return the time of the run, ms
+ */
+double runTime(double wallTime)
+{
+    return cpu_time ? runCPUTime() : wallTime;
+}
+
+/**
+ * Start a new run : the work units spent in computeWCT are counted from zero and the deadline is armed
+ * (on the wall clock, or on the CPU time of the thread with cpu_time)
+ * 
+ * @param[in] timeLimit Time allowed to the run, in ms
+ */
+void startBudget(double timeLimit)
+{
+    instance.resetNbEvaluations();
+    runGeneration = cancelGeneration.load();
+    runStopped = false;
+    runCPUStart = threadCPUTime();
+    runCPULimit = 0.;
+    if (cpu_time) {
+        runCPULimit = timeLimit > 0 ? timeLimit : 0.;
+        deadline = chrono::steady_clock::time_point::max();
+        return;
+    }
+    if (timeLimit > 0 && timeLimit < chrono::duration<double, std::milli>::max().count()) {
+        deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, std::milli>(timeLimit));
+    } else {
+        deadline = chrono::steady_clock::time_point::max();
+    }
+}
+
+/**
+ * Ask the running heuristics (of all the threads) to stop as soon as possible and return their best solution so far
+ * The runs started afterwards are not affected
+ * 
+ * Only touches a lock-free atomic, so it is safe to call from a signal handler or another thread
+ */
+void requestCancellation()
+{
+    cancelGeneration ++;
+}
+
+/**
+ * Continue a run started before (restored from a checkpoint) : the time and the work units it already spent
+ * are taken from its budget. Called after startBudget.
+ * 
+ * @param[in] wallTime Wall time already spent, ms
+ * @param[in] cpuTime CPU time already spent, ms
+ * @param[in] evaluations Work units already spent
+ */
+void resumeBudget(double wallTime, double cpuTime, double evaluations)
+{
+    instance.setNbEvaluations(evaluations);
+    runCPUStart -= cpuTime; /// runCPUTime counts the time spent before, the CPU time limit stays the same
+    if (deadline != chrono::steady_clock::time_point::max()) {
+        deadline -= chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, std::milli>(wallTime));
+    }
+}
+
+/**
+ * Test if the current run was cancelled (requestCancellation) since it started
+ * 
+ * @return true if it was, false otherwise
+ */
+bool runCancelled()
+{
+    return cancelGeneration.load() != runGeneration;
+}
+
+/**
+ * Test if the run consumed its whole evaluation budget (max_evaluations)
+ * 
+ * One work unit is one full WCT evaluation, a partial evaluation of k jobs counts k/nbJob.
+ * The result only depends on the search trajectory, not on the speed of the machine.
+ * 
+ * @return true if the search has to stop, false otherwise
+ */
+bool budgetExhausted()
+{
+    return max_evaluations > 0 && instance.getNbEvaluations() >= max_evaluations;
+}
+
+/**
+ * Cooperative check called periodically inside the constructions and the neighborhood scans
+ * 
+ * Cheap enough for the inner loops : the evaluation budget and the cancellation token are read on each call,
+ * the clock every DEADLINE_CHECK_PERIOD calls. Once the deadline is met, it is remembered in runStopped.
+ * 
+ * @return true if the search has to stop (budget exhausted, deadline met or cancellation requested), false otherwise
+ */
+bool stopRequested()
+{
+    thread_local static int nbCalls = 0;
+    if (runStopped || cancelGeneration.load(memory_order_relaxed) != runGeneration || budgetExhausted()) {
+        return true;
+    }
+    if (++nbCalls >= DEADLINE_CHECK_PERIOD) {
+        nbCalls = 0;
+        if (chrono::steady_clock::now() >= deadline || (runCPULimit > 0 && runCPUTime() >= runCPULimit)) {
+            runStopped = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,255 @@
+/*****************************************************************************
+ * Resumable and shardable campaigns : progress journal of the runs          *
+ *****************************************************************************/
+
+#ifndef _CAMPAIGN_H_
+#define _CAMPAIGN_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "objective.h"
+
+using namespace std;
+
+/// One completed run of a campaign, one line of its journal
+struct JournalEntry {
+    string instanceName;
+    int run;
+    unsigned int runSeed;
+    double time; /// time of the run written in the RTD file (wall or CPU time, see cpu_time), ms
+    int bestWCT;
+};
+
+/// completed runs, by instance then by run
+typedef map<string, map<int, JournalEntry>> CompletedRuns;
+
+FILE * journalStream = NULL; /// journal of the running campaign, NULL if none
+mutex journalMutex;
+
+/**
+ * Description of a campaign, first line of its journal : a journal is only resumed by the same campaign
+ * The targets read from the manifest are part of it, as a 64 bits FNV-1a hash.
+ *
+ * @param[in] pattern Directory or glob pattern of the instances
+ * @param[in] nbRuns Number of runs per instance
+ * @param[in] timeLimit Time limit of each run, ms
+ * @param[in] targets Target of each instance (see readTargets)
+ * @return the header line, without end of line
+ */
+string campaignHeader(string pattern, int nbRuns, double timeLimit, vector<int> & targets)
+{
+    uint64_t manifestHash = 14695981039346656037ULL;
+    for (int target : targets) {
+        for (size_t b = 0; b < sizeof(target); b++) {
+            manifestHash ^= (unsigned char)(target >> (8*b));
+            manifestHash *= 1099511628211ULL;
+        }
+    }
+    char manifest[17];
+    snprintf(manifest, sizeof(manifest), "%016llx", (unsigned long long)manifestHash);
+    ostringstream header;
+    header << "# campaign " << sls_global << " " << Objective::name() << " pattern=" << pattern << " runs=" << nbRuns
+           << " time_limit=" << timeLimit << " max_evaluations=" << max_evaluations << " clock=" << (cpu_time ? "cpu" : "wall")
+           << " manifest=" << manifest;
+    return header.str();
+}
+
+/**
+ * Read a journal : its header and its completed runs
+ * A last line without end of line (process killed while writing it) is ignored, its run will be executed again.
+ *
+ * @param[in] fileName Name of the journal
+ * @param[out] header Its header, empty if the journal is empty
+ * @param[in,out] completed The runs of the journal are added to it
+ * @param[out] completeSize Bytes of the journal up to its last end of line
+ * @return false if one error occured, true otherwise
+ */
+bool readJournal(string fileName, string & header, CompletedRuns & completed, size_t & completeSize)
+{
+    header = "";
+    ifstream journal(fileName);
+    if (!journal) {
+        generateError("campaign.h","readJournal","impossible to open a file","file_name",fileName);
+        return false;
+    }
+    stringstream buffer;
+    buffer << journal.rdbuf();
+    string text = buffer.str();
+
+    size_t lineBegin = 0;
+    size_t lineEnd;
+    while ((lineEnd = text.find('\n', lineBegin)) != string::npos) {
+        string line = text.substr(lineBegin, lineEnd - lineBegin);
+        lineBegin = lineEnd + 1;
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] == '#') {
+            if (header.empty()) {
+                header = line;
+            }
+            continue;
+        }
+        istringstream fields(line);
+        JournalEntry entry;
+        if (!(fields >> entry.instanceName >> entry.run >> entry.runSeed >> entry.time >> entry.bestWCT)) {
+            generateError("campaign.h","readJournal","malformed line","line",line);
+            return false;
+        }
+        completed[entry.instanceName][entry.run] = entry;
+    }
+    completeSize = lineBegin;
+    return true;
+}
+
+/**
+ * Open the journal of a campaign, creating it or resuming it
+ * A last line torn by a crash is cut off, the new records start on a line of their own.
+ *
+ * @param[in] fileName Name of the journal
+ * @param[in] header Header of the campaign (see campaignHeader)
+ * @param[out] completed The runs already completed
+ * @return false if one error occured (including a journal of another campaign), true otherwise
+ */
+bool openJournal(string fileName, string header, CompletedRuns & completed)
+{
+    completed.clear();
+    string journalHeader = "";
+    size_t completeSize = 0;
+    bool exists = access(fileName.c_str(), F_OK) == 0;
+    if (exists && !readJournal(fileName,journalHeader,completed,completeSize)) {
+        return false;
+    }
+    if (exists && truncate(fileName.c_str(), completeSize) != 0) {
+        generateError("campaign.h","openJournal","impossible to cut the torn last line","file_name",fileName);
+        return false;
+    }
+    if (!journalHeader.empty() && journalHeader != header) {
+        generateError("campaign.h","openJournal","the journal belongs to another campaign","journal_header",journalHeader);
+        return false;
+    }
+    journalStream = fopen(fileName.c_str(), "a");
+    if (journalStream == NULL) {
+        generateError("campaign.h","openJournal","impossible to open a file","file_name",fileName);
+        return false;
+    }
+    if (journalHeader.empty()) {
+        fprintf(journalStream, "%s\n", header.c_str());
+        fflush(journalStream);
+    }
+    return true;
+}
+
+/**
+ * Append a completed run to the journal, and flush it to the disk before returning
+ * Called by the threads executing the runs
+ *
+ * @param[in] entry The completed run
+ */
+void appendJournal(JournalEntry entry)
+{
+    lock_guard<mutex> lock(journalMutex);
+    if (journalStream == NULL) {
+        return;
+    }
+    fprintf(journalStream, "%s %d %u %.3f %d\n", entry.instanceName.c_str(), entry.run, entry.runSeed, entry.time, entry.bestWCT);
+    fflush(journalStream);
+    fsync(fileno(journalStream));
+}
+
+void closeJournal()
+{
+    lock_guard<mutex> lock(journalMutex);
+    if (journalStream != NULL) {
+        fclose(journalStream);
+        journalStream = NULL;
+    }
+}
+
+/**
+ * Read a shard specification i/k : this process executes the runs whose index (over all the instances) is i-1 modulo k
+ *
+ * @param[in] specification The shard, "i/k" with 1 <= i <= k
+ * @param[out] index i-1
+ * @param[out] count k
+ * @return false if the specification is wrong, true otherwise
+ */
+bool parseShard(string specification, int & index, int & count)
+{
+    size_t slash = specification.find('/');
+    if (slash == string::npos) {
+        generateError("campaign.h","parseShard","the shard should be i/k","shard",specification);
+        return false;
+    }
+    index = atoi(specification.substr(0, slash).c_str()) - 1;
+    count = atoi(specification.substr(slash + 1).c_str());
+    if (count < 1 || index < 0 || index >= count) {
+        generateError("campaign.h","parseShard","the shard should be i/k with 1 <= i <= k","shard",specification);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Merge journals (of the shards of a campaign, or of one resumed campaign) into an RTD file :
+ * one line per instance, sorted by name, with the times of its runs in the order of the runs
+ * The instances missing some runs are reported and left out.
+ *
+ * @param[in] outputName Name of the RTD file, overwritten
+ * @param[in] journalNames Names of the journals, of the same campaign
+ * @return false if one error occured, true otherwise
+ */
+bool mergeJournals(string outputName, vector<string> journalNames)
+{
+    CompletedRuns completed;
+    string campaign = "";
+    for (string & journalName : journalNames) {
+        string header;
+        size_t completeSize;
+        if (!readJournal(journalName,header,completed,completeSize)) {
+            return false;
+        }
+        if (campaign.empty()) {
+            campaign = header;
+        } else if (!header.empty() && header != campaign) {
+            generateError("campaign.h","mergeJournals","the journals belong to different campaigns","journal",journalName);
+            return false;
+        }
+    }
+    size_t runsPosition = campaign.find(" runs=");
+    if (runsPosition == string::npos) {
+        generateError("campaign.h","mergeJournals","no campaign header in the journals");
+        return false;
+    }
+    int nbRuns = atoi(campaign.c_str() + runsPosition + 6);
+
+    ofstream output(outputName);
+    if (!output) {
+        generateError("campaign.h","mergeJournals","impossible to open a file","file_name",outputName);
+        return false;
+    }
+    for (auto & instanceRuns : completed) {
+        if ((int)instanceRuns.second.size() < nbRuns) {
+            cerr << "incomplete : " << instanceRuns.first << ", " << instanceRuns.second.size() << " runs of " << nbRuns << endl;
+            continue;
+        }
+        string line = instanceRuns.first;
+        for (auto & run : instanceRuns.second) {
+            line += ", " + to_string((int)run.second.time);
+        }
+        output << line << '\n';
+    }
+    return true;
+}
+
+#endif
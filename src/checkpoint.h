@@ -0,0 +1,275 @@
+/*****************************************************************************
+ * Checkpoint and restore of the state of an ACO or ILS run                  *
+ *****************************************************************************/
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "budget.h"
+#include "random.h"
+#include "edits.h"
+
+using namespace std;
+
+#define CHECKPOINT_VERSION 2
+
+/// State of a run at the beginning of an iteration : the run continues exactly from it
+struct Checkpoint {
+    string algorithmName; /// ACO or ILS
+    uint64_t instanceHash; /// content of the instance (see PfspInstance::contentHash)
+    unsigned int runSeed;
+    int iteration;
+    int stagnate;
+    int lastWCT; /// ACO : WCT of the last ant, for the stagnation test
+    double temperature; /// ILS
+    vector<int> bestSol;
+    int bestWCT;
+    vector<int> currentSol; /// ILS
+    int currentWCT; /// ILS
+    vector<vector<double>> pheromones; /// ACO, (nbJob+1)x(nbJob+1)
+    double wallTime; /// ms spent by the run
+    double cpuTime; /// ms
+    double timeToBest; /// ms, wall or CPU time (see cpu_time)
+    double evaluations; /// work units spent by the run
+    long long editsOffset; /// bytes of the edits file applied to the instance (see edits.h)
+    RandomSnapshot random;
+};
+
+thread_local chrono::steady_clock::time_point lastCheckpoint; /// last time the checkpoint of the run was written
+thread_local uint64_t checkpointHash; /// content hash of the instance of the run, computed once per run and per edit
+thread_local long long checkpointHashOffset; /// editsOffset the hash was computed at, -1 if none
+
+/**
+ * Write a checkpoint, atomically : a temporary file is synced then renamed, a crash leaves the previous checkpoint
+ * Doubles are written with 17 significant digits, they are read back exactly
+ *
+ * @param[in] fileName Name of the checkpoint
+ * @param[in] checkpoint The state
+ * @return false if one error occured, true otherwise
+ */
+bool writeCheckpoint(string fileName, Checkpoint & checkpoint)
+{
+    string temporaryName = fileName + ".tmp";
+    FILE * stream = fopen(temporaryName.c_str(), "w");
+    if (stream == NULL) {
+        generateError("checkpoint.h","writeCheckpoint","impossible to open a file","file_name",temporaryName);
+        return false;
+    }
+    int nbJobs = checkpoint.bestSol.size() - 1;
+    fprintf(stream, "checkpoint %d %s %016llx %u\n", CHECKPOINT_VERSION, checkpoint.algorithmName.c_str(),
+            (unsigned long long)checkpoint.instanceHash, checkpoint.runSeed);
+    fprintf(stream, "iteration %d stagnate %d last_wct %d temperature %.17g\n", checkpoint.iteration, checkpoint.stagnate,
+            checkpoint.lastWCT, checkpoint.temperature);
+    fprintf(stream, "budget %.17g %.17g %.17g %.17g\n", checkpoint.wallTime, checkpoint.cpuTime, checkpoint.timeToBest, checkpoint.evaluations);
+    fprintf(stream, "edits %lld\n", checkpoint.editsOffset);
+    fprintf(stream, "best %d %d", checkpoint.bestWCT, nbJobs);
+    for (int j = 1; j <= nbJobs; j++) {
+        fprintf(stream, " %d", checkpoint.bestSol[j]);
+    }
+    fprintf(stream, "\ncurrent %d %d", checkpoint.currentWCT, (int)checkpoint.currentSol.size() - 1);
+    for (size_t j = 1; j < checkpoint.currentSol.size(); j++) {
+        fprintf(stream, " %d", checkpoint.currentSol[j]);
+    }
+    fprintf(stream, "\npheromones %d\n", (int)checkpoint.pheromones.size() - 1);
+    for (size_t i = 1; i < checkpoint.pheromones.size(); i++) {
+        for (size_t j = 1; j < checkpoint.pheromones[i].size(); j++) {
+            fprintf(stream, j == 1 ? "%.17g" : " %.17g", checkpoint.pheromones[i][j]);
+        }
+        fprintf(stream, "\n");
+    }
+    fprintf(stream, "random %d %d ", checkpoint.random.frontOffset, checkpoint.random.rearOffset);
+    for (int b = 0; b < RANDOM_STATE_SIZE; b++) {
+        fprintf(stream, "%02x", (unsigned char)checkpoint.random.buffer[b]);
+    }
+    fprintf(stream, "\nend\n");
+
+    bool written = fflush(stream) == 0 && fsync(fileno(stream)) == 0;
+    written = fclose(stream) == 0 && written;
+    if (!written || rename(temporaryName.c_str(), fileName.c_str()) != 0) {
+        generateError("checkpoint.h","writeCheckpoint","impossible to write the checkpoint","file_name",fileName);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read a checkpoint written by writeCheckpoint
+ *
+ * @param[in] fileName Name of the checkpoint
+ * @param[out] checkpoint The state
+ * @return false if one error occured (including a truncated or malformed file), true otherwise
+ */
+bool readCheckpoint(string fileName, Checkpoint & checkpoint)
+{
+    ifstream stream(fileName);
+    if (!stream) {
+        generateError("checkpoint.h","readCheckpoint","impossible to open a file","file_name",fileName);
+        return false;
+    }
+    string key[10];
+    int version;
+    string hash;
+    stream >> key[0] >> version >> checkpoint.algorithmName >> hash >> checkpoint.runSeed;
+    checkpoint.instanceHash = strtoull(hash.c_str(), NULL, 16);
+    stream >> key[1] >> checkpoint.iteration >> key[2] >> checkpoint.stagnate >> key[3] >> checkpoint.lastWCT
+           >> key[4] >> checkpoint.temperature;
+    stream >> key[5] >> checkpoint.wallTime >> checkpoint.cpuTime >> checkpoint.timeToBest >> checkpoint.evaluations;
+
+    stream >> key[9] >> checkpoint.editsOffset;
+
+    int size;
+    stream >> key[6] >> checkpoint.bestWCT >> size;
+    checkpoint.bestSol.assign(max(size,0)+1, 0);
+    for (int j = 1; j <= size && stream; j++) {
+        stream >> checkpoint.bestSol[j];
+    }
+    stream >> key[7] >> checkpoint.currentWCT >> size;
+    checkpoint.currentSol.assign(max(size,0)+1, 0);
+    for (int j = 1; j <= size && stream; j++) {
+        stream >> checkpoint.currentSol[j];
+    }
+    stream >> key[8] >> size;
+    checkpoint.pheromones.assign(max(size,0)+1, vector<double>(max(size,0)+1, 0.));
+    for (int i = 1; i <= size && stream; i++) {
+        for (int j = 1; j <= size && stream; j++) {
+            stream >> checkpoint.pheromones[i][j];
+        }
+    }
+
+    string randomKey, randomBuffer, endKey;
+    stream >> randomKey >> checkpoint.random.frontOffset >> checkpoint.random.rearOffset >> randomBuffer >> endKey;
+    if (!stream || version != CHECKPOINT_VERSION || key[0] != "checkpoint" || key[9] != "edits" || key[6] != "best" || key[8] != "pheromones"
+        || randomKey != "random" || randomBuffer.size() != 2*RANDOM_STATE_SIZE || endKey != "end") {
+        generateError("checkpoint.h","readCheckpoint","malformed or truncated checkpoint","file_name",fileName);
+        return false;
+    }
+    for (int b = 0; b < RANDOM_STATE_SIZE; b++) {
+        checkpoint.random.buffer[b] = (char)strtoul(randomBuffer.substr(2*b, 2).c_str(), NULL, 16);
+    }
+    return true;
+}
+
+/**
+ * Look for the checkpoint of the run (checkpoint_file) : a run of the same heuristic, on the same instance
+ *
+ * @param[in] algorithmName ACO or ILS
+ * @param[out] checkpoint The state to resume from, if any
+ * @param[out] resumed True if the run has to resume from the checkpoint, false if it starts from scratch
+ * @return false if one error occured (including a checkpoint of another run), true otherwise
+ */
+bool loadCheckpoint(string algorithmName, Checkpoint & checkpoint, bool & resumed)
+{
+    resumed = false;
+    lastCheckpoint = chrono::steady_clock::now();
+    checkpointHashOffset = -1;
+    if (checkpoint_file.empty() || access(checkpoint_file.c_str(), F_OK) != 0) {
+        return true;
+    }
+    if (!readCheckpoint(checkpoint_file,checkpoint)) {
+        return false;
+    }
+    if (!replayEdits(checkpoint.editsOffset)) { /// the instance of the run is the one of its file, edited
+        return false;
+    }
+    if (checkpoint.algorithmName != algorithmName || checkpoint.instanceHash != instance.contentHash()
+        || (int)checkpoint.bestSol.size() != instance.getNbJob()+1) {
+        generateError("checkpoint.h","loadCheckpoint","the checkpoint belongs to another heuristic or instance","checkpoint",checkpoint_file);
+        return false;
+    }
+    seed = checkpoint.runSeed;
+    resumed = true;
+    if (!quiet) {
+        cout << "resumed from " << checkpoint_file << " : iteration " << checkpoint.iteration << ", best " << checkpoint.bestWCT
+             << ", " << checkpoint.wallTime/1000. << "s and " << checkpoint.evaluations << " evaluations already spent" << endl;
+    }
+    return true;
+}
+
+/**
+ * Fill the part of the checkpoint shared by the heuristics : budget spent and generator, at the beginning of an iteration
+ * The content hash of the instance is only recomputed when edits were applied since the last capture
+ *
+ * @param[in] algorithmName ACO or ILS
+ * @param[in] wallTime Wall time of the run so far, ms
+ * @param[in] timeToBest Time to best of the run so far, ms
+ * @param[out] checkpoint The state
+ */
+void captureCheckpoint(string algorithmName, double wallTime, double timeToBest, Checkpoint & checkpoint)
+{
+    checkpoint.algorithmName = algorithmName;
+    if (checkpointHashOffset != editsOffset) {
+        checkpointHash = instance.contentHash();
+        checkpointHashOffset = editsOffset;
+    }
+    checkpoint.instanceHash = checkpointHash;
+    checkpoint.runSeed = seed;
+    checkpoint.wallTime = wallTime;
+    checkpoint.cpuTime = runCPUTime();
+    checkpoint.timeToBest = timeToBest;
+    checkpoint.evaluations = instance.getNbEvaluations();
+    checkpoint.editsOffset = editsOffset;
+    saveRandom(checkpoint.random);
+}
+
+/**
+ * Test if the state of the current iteration has to be captured : first iteration of the run (nothing captured yet,
+ * the state is kept for a cancellation) or checkpoint_period ms passed since the last write
+ *
+ * @param[in] checkpoint The state captured so far
+ * @return true if the state has to be captured, false otherwise
+ */
+bool checkpointDue(Checkpoint & checkpoint)
+{
+    return checkpoint.algorithmName.empty()
+           || chrono::duration<double, std::milli>(chrono::steady_clock::now() - lastCheckpoint).count() >= checkpoint_period;
+}
+
+/**
+ * Write the checkpoint if checkpoint_period ms passed since the last one
+ *
+ * @param[in] checkpoint The state at the beginning of the current iteration
+ * @return false if one error occured, true otherwise
+ */
+bool periodicCheckpoint(Checkpoint & checkpoint)
+{
+    auto now = chrono::steady_clock::now();
+    if (chrono::duration<double, std::milli>(now - lastCheckpoint).count() < checkpoint_period) {
+        return true;
+    }
+    lastCheckpoint = now;
+    return writeCheckpoint(checkpoint_file,checkpoint);
+}
+
+/**
+ * End of a checkpointed run : if it was cancelled (SIGTERM, SIGINT), the last captured state is written, the next run
+ * with the same checkpoint resumes it; if it completed, the checkpoint is removed
+ *
+ * @param[in] checkpoint The state at the beginning of the last captured iteration (see checkpointDue)
+ * @return false if one error occured, true otherwise
+ */
+bool finishCheckpoint(Checkpoint & checkpoint)
+{
+    if (runCancelled()) {
+        if (!writeCheckpoint(checkpoint_file,checkpoint)) {
+            return false;
+        }
+        if (!quiet) {
+            cout << "interrupted, checkpoint of iteration " << checkpoint.iteration << " written to " << checkpoint_file << endl;
+        }
+        return true;
+    }
+    remove(checkpoint_file.c_str());
+    return true;
+}
+
+#endif
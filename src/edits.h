@@ -0,0 +1,270 @@
+/*****************************************************************************
+ * Edits of the instance during a run, and repair of the solver state        *
+ *****************************************************************************/
+
+#ifndef _EDITS_H_
+#define _EDITS_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <sys/stat.h>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "objective.h"
+#include "lowerBound.h"
+#include "localSearch.h"
+
+using namespace std;
+
+/**
+ * One edit of the instance, one line of the edits file. The jobs are numbered as in the instance when the edit is applied
+ * (after a removal, the jobs after the removed one are renumbered j-1; an added job gets the number nbJob+1) :
+ *      add <due date> <weight> <time on machine 1> ... <time on machine m>
+ *      remove <job>
+ *      time <job> <machine> <processing time>
+ *      weight <job> <weight>
+ *      due <job> <due date>
+ */
+struct InstanceEdit {
+    string kind;
+    int job = 0;
+    int machine = 0;
+    int value = 0;
+    int dueDate = 0;
+    int weight = 0;
+    vector<int> times; /// add : times[1:nbMac]
+};
+
+thread_local long long editsOffset = 0; /// bytes of the edits file already applied by the run
+
+/**
+ * Read an edit
+ *
+ * @param[in] line One line of the edits file
+ * @param[out] edit The edit
+ * @return false if the line is not a valid edit of the global instance, true otherwise
+ */
+bool parseEdit(string line, InstanceEdit & edit)
+{
+    istringstream fields(line);
+    bool valid = (bool)(fields >> edit.kind);
+    int nbJobs = instance.getNbJob();
+    if (edit.kind == "add") {
+        edit.times.assign(instance.getNbMac()+1, 0);
+        valid = valid && (bool)(fields >> edit.dueDate >> edit.weight);
+        for (int m = 1; m <= instance.getNbMac() && valid; m++) {
+            valid = (bool)(fields >> edit.times[m]) && edit.times[m] >= 0;
+        }
+    } else if (edit.kind == "remove") {
+        valid = valid && (bool)(fields >> edit.job) && nbJobs > 1;
+    } else if (edit.kind == "time") {
+        valid = valid && (bool)(fields >> edit.job >> edit.machine >> edit.value) && edit.machine >= 1
+                && edit.machine <= instance.getNbMac() && edit.value >= 0;
+    } else if (edit.kind == "weight" || edit.kind == "due") {
+        valid = valid && (bool)(fields >> edit.job >> edit.value);
+    } else {
+        valid = false;
+    }
+    if (edit.kind != "add" && (edit.job < 1 || edit.job > nbJobs)) {
+        valid = false;
+    }
+    if (!valid) {
+        generateError("edits.h","parseEdit","invalid edit, ignored","line",line);
+    }
+    return valid;
+}
+
+/**
+ * Apply an edit to the global instance, and keep track of the jobs of the solutions built before it
+ *
+ * @param[in] edit The edit (see parseEdit)
+ * @param[in,out] jobMap Number of each job of the solutions, jobMap[old job] = its number now, 0 if it was removed
+ * @param[in,out] addedJobs Jobs added since, not in the solutions
+ * @return false if one error occured, true otherwise
+ */
+bool applyEdit(InstanceEdit & edit, vector<int> & jobMap, vector<int> & addedJobs)
+{
+    if (edit.kind == "add") {
+        addedJobs.push_back(instance.addJob(edit.times,edit.dueDate,edit.weight));
+    } else if (edit.kind == "remove") {
+        if (!instance.removeJob(edit.job)) {
+            return false;
+        }
+        for (int & job : jobMap) {
+            job = job == edit.job ? 0 : (job > edit.job ? job - 1 : job);
+        }
+        addedJobs.erase(remove(addedJobs.begin(), addedJobs.end(), edit.job), addedJobs.end());
+        for (int & job : addedJobs) {
+            job = job > edit.job ? job - 1 : job;
+        }
+    } else if (edit.kind == "time") {
+        instance.setTime(edit.job,edit.machine,edit.value);
+    } else if (edit.kind == "weight") {
+        instance.setPriority(edit.job,edit.value);
+    } else {
+        instance.setDueDate(edit.job,edit.value);
+    }
+    return true;
+}
+
+/**
+ * Apply the complete lines of the edits file (edits_file) from editsOffset to endOffset, and move editsOffset after them
+ * The lower bound is computed again if the instance changed.
+ *
+ * @param[in] endOffset End of the edits to apply, negative for the end of the file (the incomplete last line is left)
+ * @param[out] jobMap Number now of each job of the solutions built before the call, 0 if it was removed
+ * @param[out] addedJobs Jobs added by the call
+ * @param[out] edited True if the instance changed, false otherwise
+ * @return false if one error occured, true otherwise
+ */
+bool readEdits(long long endOffset, vector<int> & jobMap, vector<int> & addedJobs, bool & edited)
+{
+    edited = false;
+    ifstream editsStream(edits_file);
+    if (!editsStream) {
+        generateError("edits.h","readEdits","impossible to open a file","file_name",edits_file);
+        return false;
+    }
+    editsStream.seekg(editsOffset);
+    stringstream buffer;
+    buffer << editsStream.rdbuf();
+    string text = buffer.str();
+    if (endOffset >= 0) {
+        text = text.substr(0, max(endOffset - editsOffset, 0LL));
+    }
+
+    jobMap.resize(instance.getNbJob()+1);
+    for (int job = 0; job <= instance.getNbJob(); job++) {
+        jobMap[job] = job;
+    }
+    addedJobs.clear();
+    size_t lineBegin = 0;
+    size_t lineEnd;
+    while ((lineEnd = text.find('\n', lineBegin)) != string::npos) {
+        string line = text.substr(lineBegin, lineEnd - lineBegin);
+        lineBegin = lineEnd + 1;
+        InstanceEdit edit;
+        if (line.empty() || line[0] == '#' || !parseEdit(line,edit)) {
+            continue;
+        }
+        if (!applyEdit(edit,jobMap,addedJobs)) {
+            return false;
+        }
+        edited = true;
+    }
+    editsOffset += lineBegin;
+
+    if (edited) {
+        if (!checkObjectiveRange(edits_file) || !computeLowerBound(lb_threads)) {
+            return false;
+        }
+        if (!quiet) {
+            cout << "instance edited : " << instance.getNbJob() << " jobs, lower bound = " << lowerBound << endl;
+        }
+    }
+    return true;
+}
+
+/**
+ * Apply the edits appended to the edits file since the last call, called between two iterations of the heuristics
+ * The file is only read when it grew.
+ *
+ * @param[out] jobMap Number now of each job of the solutions built before the call, 0 if it was removed
+ * @param[out] addedJobs Jobs added by the call
+ * @param[out] edited True if the instance changed, false otherwise
+ * @return false if one error occured, true otherwise
+ */
+bool pollEdits(vector<int> & jobMap, vector<int> & addedJobs, bool & edited)
+{
+    edited = false;
+    struct stat editsStat;
+    if (stat(edits_file.c_str(),&editsStat) != 0 || editsStat.st_size <= editsOffset) {
+        return true;
+    }
+    return readEdits(-1,jobMap,addedJobs,edited);
+}
+
+/**
+ * Apply again to the instance read from its file the edits a run had applied before its checkpoint (see checkpoint.h)
+ *
+ * @param[in] endOffset Bytes of the edits file applied by the run
+ * @return false if one error occured, true otherwise
+ */
+bool replayEdits(long long endOffset)
+{
+    vector<int> jobMap;
+    vector<int> addedJobs;
+    bool edited;
+    editsOffset = 0;
+    if (endOffset <= 0) {
+        return true;
+    }
+    if (edits_file.empty()) {
+        generateError("edits.h","replayEdits","the checkpoint was taken after edits of the instance, give their file (--edits)");
+        return false;
+    }
+    return readEdits(endOffset,jobMap,addedJobs,edited);
+}
+
+/**
+ * Repair a solution built before the edits : the removed jobs are dropped, the others renumbered,
+ * each added job is inserted at its best position (constructSolMinWCT), and the solution is evaluated again
+ *
+ * @param[in,out] sol The solution
+ * @param[out] wct Its value on the edited instance
+ * @param[in] jobMap See pollEdits
+ * @param[in] addedJobs See pollEdits
+ * @return false if one error occured, true otherwise
+ */
+bool repairSolution(vector<int> & sol, int & wct, vector<int> & jobMap, vector<int> & addedJobs)
+{
+    ScopedPhase phase("repairSolution");
+    int nbJobs = instance.getNbJob();
+    vector<int> repaired (nbJobs+2, 0);
+    int nbPlaced = 0;
+    for (int i = 1; i < (int)sol.size(); i++) {
+        if (jobMap[sol[i]] > 0) {
+            nbPlaced ++;
+            repaired[nbPlaced] = jobMap[sol[i]];
+        }
+    }
+    for (int job : addedJobs) {
+        if (!constructSolMinWCT(nbPlaced,job,repaired)) { return false; }
+        nbPlaced ++;
+    }
+    repaired.resize(nbJobs+1);
+    sol = repaired;
+    return Objective::evaluate(nbJobs,sol,wct);
+}
+
+/**
+ * Repair the pheromone matrix of the ACO (rows : jobs, columns : positions) : the rows of the kept jobs are
+ * kept and renumbered, the rows of the added jobs and the new positions start at the initial amount (see initPheromones)
+ *
+ * @param[in,out] pheromones The matrix, resized to the edited instance
+ * @param[in] jobMap See pollEdits
+ * @param[in] bestWCT Value of the repaired best solution, 1/(initial amount of pheromones)
+ */
+void repairPheromones(vector<vector<double>> & pheromones, vector<int> & jobMap, int bestWCT)
+{
+    int nbJobs = instance.getNbJob();
+    int oldNbJobs = pheromones.size() - 1;
+    double phiInit = 1 / ((double)max(bestWCT,1));
+    vector<vector<double>> repaired (nbJobs+1, vector<double>(nbJobs+1, phiInit));
+    for (int job = 1; job <= oldNbJobs; job++) {
+        if (jobMap[job] == 0) {
+            continue;
+        }
+        for (int position = 1; position <= min(oldNbJobs,nbJobs); position++) {
+            repaired[jobMap[job]][position] = pheromones[job][position];
+        }
+    }
+    pheromones.swap(repaired);
+}
+
+#endif
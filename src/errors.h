@@ -36,10 +36,22 @@ void generateError(string file, string method, string message)
  */
 void help()
 {
-    cout << "Usage: ./main --SLS <ILS or ACO> --instance_file <e.g ../instances/50_20_01> --max_iterations <int>" << endl << endl;
+    cout << "Usage: ./main --SLS <ILS, ACO or IG> --instance_file <e.g ../instances/50_20_01> --max_iterations <int> --max_evaluations <double> [--checkpoint <file> [--checkpoint_period <ms>]] [--store <directory> [--store_elite <k>]] [--initial_solution <permutation file|->] [--edits <file>]" << endl << endl;
+
+    cout << "Experiment : ./main --SLS <ILS, ACO or IG> --experiment <directory or glob> --manifest <targets file> --runs <int> --time_limit <ms> [--max_evaluations <units>] [--threads <int>] [--cpu_time] [--journal <file> [--shard <i>/<k>]]" << endl;
+    cout << "Merge of campaign journals : ./main --merge <RTD file> <journal>..." << endl;
+    cout << "Scaling benchmark : ./main --SLS <ILS, ACO or IG> --scaling <directory or glob> --threads <max threads> --runs <runs per thread> [--max_evaluations <units>] [--scaling_output <json file>]" << endl;
+    cout << "Binary image of an instance : ./main --convert <instance file> <binary file>" << endl << endl;
+    cout << "Synthetic instance : ./main --generate <instance file|-> --jobs <n> --machines <m> [--seed <s>] [--distribution uniform|job_correlated|machine_correlated|exponential] [--min_time <t>] [--max_time <t>] [--max_priority <w>] [--due_factor <f>]" << endl << endl;
+    cout << "Batch of instances : ./main --SLS <ILS, ACO or IG> --batch <list of instances|-> [--threads <int>] [--time_limit <ms>] [--max_evaluations <units>] [--seed <s>] [--max_iterations <int>] [--results <file>]" << endl;
+    cout << "Solver daemon : ./main --serve <socket path|-> [--workers <n>] [--queue <n>] [--preload <directory or glob>] [--SLS <default SLS>] [--time_limit <ms>] [--max_evaluations <units>] [--store <directory>] [--results <file>]" << endl;
+    cout << "   one JSON request per line, e.g. {\"id\":\"r1\",\"instance\":\"../instances/50_20_01\",\"sls\":\"ILS\",\"max_evaluations\":100000,\"seed\":7,\"progress\":true}" << endl << endl;
+    cout << "Performance regression check : ./main --regression <baseline.json> [--tolerance <fraction>] [--update_baseline]" << endl << endl;
 
     cout << "Exemple : ./main --SLS ACO --instance_file ../instances/50_20_01" << endl;
-    cout << "Exemple : ./main --SLS ILS --instance_file ../instances/100_20_02 --max_iterations 60" << endl << endl;
+    cout << "Exemple : ./main --SLS ILS --instance_file ../instances/100_20_02 --max_iterations 60" << endl;
+    cout << "Exemple : ./main --SLS ILS --instance_file ../instances/100_20_02 --max_iterations 100000 --max_evaluations 200000" << endl;
+    cout << "Exemple : ./main --SLS IG --instance_file ../instances/50_20_01 --nbDestructions 4 --max_iterations 200" << endl << endl;
 }
 
 template<typename T1>
@@ -14,31 +14,179 @@
 #include <chrono>
 
 #include <unistd.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 #include "globalVariables.h"
 #include "files.h"
 #include "aco.h"
 #include "ils.h"
+#include "ig.h"
+#include "campaign.h"
+
+/**
+ * All the runs of an instance
+ * 
+ * @param[in] nbRuns Number of runs
+ * @return the indices 0..nbRuns-1
+ */
+vector<int> allRuns(int nbRuns)
+{
+    vector<int> runIndices (nbRuns);
+    for (int run = 0; run < nbRuns; run++) {
+        runIndices[run] = run;
+    }
+    return runIndices;
+}
 
-// RTD ANALYSIS
-bool runExperimentTwo() {
-    auto start = chrono::high_resolution_clock::now();
-    auto end = chrono::high_resolution_clock::now();
-    chrono::duration<double, std::milli> ms_double;
+/**
+ * Execute the given runs of the heuristic (sls_global, default parameters) on the global instance, on nbThreads threads
+ * 
+ * The runs are taken in order from a shared counter, each one is executed on one thread, and appended to the journal
+ * of the campaign if there is one (see campaign.h). A cancellation (SIGINT/SIGTERM) ends the batch : the runs it cut short
+ * are dropped (not journaled, not in the results), the callers test cancelGeneration to know it happened. The spawned threads work on
+ * their own copy of the instance (the solver state is thread_local, see globalVariables.h); with one thread, the runs
+ * are executed on the calling thread. The seed of run r is seedOffset + 60*r, whatever the thread executing it.
+ * 
+ * @param[in] instanceName Name of the instance, for the results and the trace
+ * @param[in] target WCT whose time to reach is measured
+ * @param[in] stopAtTarget True if the runs stop once they reach the target
+ * @param[in] timeLimit Time limit of each run, ms
+ * @param[in] nbRuns Number of runs of the instance, size of the outputs
+ * @param[in] runIndices Runs to execute, in [0,nbRuns)
+ * @param[in] nbThreads Number of threads executing the runs
+ * @param[in] seedOffset Seed of the first run
+ * @param[out] runTimes Wall time of each run, or its CPU time with cpu_time, ms
+ * @param[out] runResults Result of each run
+ * @param[out] targetTimes Time when each run reached the target, ms since the beginning of the batch (CPU time of the run with cpu_time), negative if never
+ * @return false if one error occured, true otherwise
+ */
+bool executeRuns(string instanceName, int target, bool stopAtTarget, double timeLimit, int nbRuns, vector<int> & runIndices, int nbThreads, unsigned int seedOffset,
+                 vector<double> & runTimes, vector<RunResult> & runResults, vector<double> & targetTimes)
+{
+    runTimes.assign(nbRuns, 0.);
+    runResults.assign(nbRuns, RunResult());
+    targetTimes.assign(nbRuns, -1.);
+
+    PfspInstance & sharedInstance = instance;
+    long long sharedLowerBound = lowerBound;
+    SLS sharedSLS = sls_global;
+    double sharedMaxEvaluations = max_evaluations;
+    auto batchStart = chrono::steady_clock::now();
+    int batchGeneration = cancelGeneration.load();
+    int nbSelected = runIndices.size();
+    atomic<int> nextRun (0);
+    atomic<bool> failed (false);
+    mutex outputMutex; /// console and trace file
+
+    auto worker = [&](bool spawned) {
+        if (spawned) {
+            instance = sharedInstance;
+            lowerBound = sharedLowerBound;
+            sls_global = sharedSLS;
+            max_evaluations = sharedMaxEvaluations;
+        }
+        bool readParams = false;
+        for (int next = nextRun++; next < nbSelected && !failed && cancelGeneration.load() == batchGeneration; next = nextRun++) {
+            int run = runIndices[next];
+            if (!quiet) {
+                lock_guard<mutex> lock(outputMutex);
+                cout << "run : " << run << endl;
+            }
+            /// initialize random seed
+            seed = seedOffset + 60*run;
+            seedRandom(seed);
+            int runTarget = stopAtTarget ? target : 0;
+            traceTarget = target;
 
+            auto start = chrono::steady_clock::now();
+            bool ok;
+            if (sls_global == ACO) {
+                ok = ACO_heuristic(readParams,runTarget,timeLimit);
+            } else if (sls_global == ILS) {
+                ok = ILS_heuristic(readParams,runTarget,timeLimit);
+            } else {
+                ok = IG_heuristic(readParams,runTarget,timeLimit);
+            }
+            if (!ok) {
+                failed = true;
+                return;
+            }
+            auto end = chrono::steady_clock::now();
+
+            runTimes[run] = cpu_time ? lastRun.cpuTime : chrono::duration<double, std::milli>(end - start).count();
+            runResults[run] = lastRun;
+            double runStart = cpu_time ? 0. : chrono::duration<double, std::milli>(start - batchStart).count();
+            if (traceTargetTime >= 0) {
+                targetTimes[run] = runStart + traceTargetTime;
+            }
+
+            /// a run cut short by a signal is not completed : a resumed campaign executes it again, from scratch
+            if (cancelGeneration.load() != batchGeneration) {
+                return;
+            }
+            appendJournal({instanceName, run, seed, runTimes[run], lastRun.bestWCT});
+            mergeLatencies();
+            if (!results_file.empty()) {
+                pushResult(instanceName,lastRun);
+            }
+            if (!trace_file.empty()) {
+                lock_guard<mutex> lock(outputMutex);
+                writeTrace(trace_file,instanceName);
+            }
+        }
+    };
+
+    if (nbThreads <= 1) {
+        worker(false);
+    } else {
+        vector<thread> threads;
+        for (int t = 0; t < nbThreads && t < nbSelected; t++) {
+            threads.push_back(thread(worker,true));
+        }
+        for (thread & th : threads) {
+            th.join();
+        }
+    }
+    return !failed;
+}
+
+// RTD ANALYSIS
+/**
+ * Run each instance matching the pattern nbRuns times, and write the time needed to reach its target
+ * 
+ * @param[in] pattern Directory or glob pattern of the instances
+ * @param[in] manifestName Manifest of the best known values and target coefficients (see readTargets)
+ * @param[in] nbRuns Number of runs per instance
+ * @param[in] timeLimit Time limit of each run, ms
+ * The runs of an instance are executed on experiment_threads threads (--threads)
+ * With a journal (--journal), the completed runs are recorded as they end, a restarted campaign skips them, and the
+ * RTD file is rewritten from the journal at the end. With a shard i/k (--shard), only the runs whose index over the
+ * campaign is i-1 modulo k are executed, the RTD file is then produced by merging the journals of the shards (--merge).
+ * @return false if one error occured, true otherwise
+ */
+bool runExperimentTwo(string pattern, string manifestName, int nbRuns, double timeLimit) {
     vector<string> fileNames;
     vector<string> instanceNames;
 
-    vector<int> TIME_vect (25);
+    vector<double> TIME_vect (nbRuns);
+    vector<RunResult> runResults;
+    vector<double> targetTimes;
 
     int nbFiles = 0;
-    double nbMS100 = 0.;
-    double nbMS50 = 0.;
-    bool readParams = false;
-    vector<int> targets (5);
-    double timeLimit = 0.;
+    vector<int> targets;
 
-    fillFileNames(fileNames,instanceNames,nbFiles,targets,timeLimit);
+    if (!fillFileNames(pattern,fileNames,instanceNames,nbFiles)) {
+        return false;
+    }
+    if (!readTargets(manifestName,instanceNames,targets)) {
+        return false;
+    }
+
+    resetHistogram(allVndLatency);
+    resetHistogram(allIterationLatency);
+    resetHistogram(allConstructionLatency);
 
     string fileName;
     char * cfileName;
@@ -47,50 +195,91 @@ bool runExperimentTwo() {
     getFileName(fileName);
     cfileName = &fileName[0];
     
-    emptyFile(cfileName);
+    CompletedRuns completed;
+    bool resumable = !journal_file.empty();
+    int campaignGeneration = cancelGeneration.load();
+    if (resumable) {
+        if (!openJournal(journal_file,campaignHeader(pattern,nbRuns,timeLimit,targets),completed)) {
+            return false;
+        }
+    } else {
+        emptyFile(cfileName);
+    }
 
-    cout << "\nfileName = " << fileName << endl << endl;
+    if (!quiet) {
+        cout << "\nfileName = " << fileName << endl << endl;
+    }
+
+    if (!results_file.empty() && !startResultsWriter(results_file)) {
+        return false;
+    }
 
     string line = "";
 
     for (int i = 0; i < nbFiles; i++) {
         instance_file = &fileNames[i][0];
-        cout << instance_file << endl;
+        if (!quiet) {
+            cout << instance_file << endl;
+        }
 
         line = "";
         line += instanceNames[i];
 
+        /// runs of this shard not completed yet
+        vector<int> runIndices;
+        for (int run = 0; run < nbRuns; run ++) {
+            if ((i*nbRuns + run) % shard_count == shard_index && completed[instanceNames[i]].count(run) == 0) {
+                runIndices.push_back(run);
+            }
+        }
+        if (runIndices.empty()) {
+            if (!quiet) {
+                cout << "nothing to run" << endl;
+            }
+            continue;
+        }
+
         /// Read data from file
-        if (!instance.readDataFromFile(instance_file)) {
+        if (!loadInstance(instance_file)) {
+            closeJournal();
+            stopResultsWriter();
             return false;
         }
 
-        for (int run = 0; run < 25; run ++) {
-            cout << "run : " << run << endl;
-            /// initialize random seed
-            srand ( i+60*run);
-
-            start = chrono::high_resolution_clock::now();
-
-            if (sls_global == ACO) {
-                if (!ACO_heuristic(readParams,targets[i],timeLimit)) {
-                    return false;
-                }
-            } else {
-                if (!ILS_heuristic(readParams,targets[i],timeLimit)) {
-                    return false;
-                }
-            }
+        if (!executeRuns(instanceNames[i],targets[i],true,timeLimit,nbRuns,runIndices,experiment_threads,i,TIME_vect,runResults,targetTimes)) {
+            closeJournal();
+            stopResultsWriter();
+            return false;
+        }
+        if (cancelGeneration.load() != campaignGeneration) {
+            cout << (resumable ? "interrupted, resume with the same command" : "interrupted, the runs of this instance are not written") << endl;
+            break;
+        }
+        if (resumable) {
+            continue;
+        }
+        for (int run = 0; run < nbRuns; run ++) {
+            line += ", " + to_string((int)TIME_vect[run]);
+        }
 
-            end = chrono::high_resolution_clock::now();
-            ms_double = end - start;
+        appendToFile(cfileName,line);
+    }
 
-            TIME_vect[run] = ms_double.count();
+    stopResultsWriter();
 
-            line += ", " + to_string(TIME_vect[run]);
+    if (resumable) {
+        closeJournal();
+        if (shard_count == 1 && cancelGeneration.load() == campaignGeneration && !mergeJournals(fileName,{journal_file})) {
+            return false;
         }
+    }
 
-        appendToFile(cfileName,line);
+    if (latency_report) {
+        printLatencies("all runs",allVndLatency,allIterationLatency,allConstructionLatency);
+    }
+
+    if (!phase_trace_file.empty() && !exportPhaseTrace(phase_trace_file)) {
+        return false;
     }
 
     return true;
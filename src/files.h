@@ -9,13 +9,131 @@
 #include <vector>
 #include <fstream>
 #include <cmath>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glob.h>
+#include <map>
+#include <sstream>
+#include <algorithm>
 
 #include "pfspinstance.h"
 #include "globalVariables.h"
 #include "errors.h"
+#include "lowerBound.h"
 
 using namespace std;
 
+/**
+ * Read the instance denoted by the given name into the global instance, going through the binary cache
+ * 
+ * Binary images (see PfspInstance::writeBinaryFile) are read directly. A text instance is read from its
+ * sidecar fileName.bin when the sidecar was written from the same text (same size and modification time, to the
+ * nanosecond), otherwise it is parsed and the sidecar is (re)written for the next loads. Failing to write the sidecar is not an error. "-" is the standard input.
+ * 
+ * @param[in] fileName Name of the instance file
+ * @return false if one error occured, true otherwise
+ */
+bool readInstanceCached(string fileName)
+{
+    if (fileName == "-") { /// standard input, nothing to cache
+        return instance.readDataFromFile(fileName);
+    }
+    if (PfspInstance::isBinaryFile(fileName)) {
+        return instance.readBinaryFile(fileName);
+    }
+    if (!use_instance_cache) {
+        return instance.readDataFromFile(fileName);
+    }
+
+    string cacheName = fileName + ".bin";
+    struct stat textStat;
+    if (stat(fileName.c_str(),&textStat) != 0) {
+        return instance.readDataFromFile(fileName);
+    }
+    if (access(cacheName.c_str(),F_OK) == 0 && instance.readBinaryFile(cacheName,&textStat)) {
+        return true;
+    }
+
+    if (!instance.readDataFromFile(fileName)) {
+        return false;
+    }
+    instance.writeBinaryFile(cacheName,&textStat);
+    return true;
+}
+
+/**
+ * Read a permutation of the jobs of the global instance : its jobs separated by spaces, commas or new lines,
+ * optionally preceded by its value (a line of a store file, see store.h). Lines starting with # are ignored.
+ * 
+ * @param[in] fileName Name of the file, "-" for the standard input
+ * @param[out] sol The permutation, sol[1:nbJob]
+ * @return false if one error occured (including a file which is not a permutation of the jobs), true otherwise
+ */
+bool readPermutation(string fileName, vector<int> & sol)
+{
+    ifstream fileStream;
+    if (fileName != "-") {
+        fileStream.open(fileName);
+        if (!fileStream) {
+            generateError("files.h","readPermutation","impossible to open a file","file_name",fileName);
+            return false;
+        }
+    }
+    istream & input = fileName == "-" ? cin : fileStream;
+    vector<int> values;
+    string line;
+    while (getline(input, line)) {
+        if (!line.empty() && line[0] == '#') {
+            continue;
+        }
+        replace(line.begin(), line.end(), ',', ' ');
+        istringstream fields(line);
+        int value;
+        while (fields >> value) {
+            values.push_back(value);
+        }
+    }
+
+    int nbJobs = instance.getNbJob();
+    if ((int)values.size() != nbJobs && (int)values.size() != nbJobs+1) {
+        generateError("files.h","readPermutation","the permutation should have one position per job","positions",values.size());
+        return false;
+    }
+    int first = values.size() - nbJobs; /// 1 if the value is given
+    sol.assign(nbJobs+1, 0);
+    vector<bool> used (nbJobs+1, false);
+    for (int j = 1; j <= nbJobs; j++) {
+        int job = values[first + j - 1];
+        if (job < 1 || job > nbJobs || used[job]) {
+            generateError("files.h","readPermutation","job missing, repeated or out of range","job",job);
+            return false;
+        }
+        used[job] = true;
+        sol[j] = job;
+    }
+    return true;
+}
+
+/**
+ * Read the instance denoted by the given name into the global instance and compute its lower bound
+ * 
+ * @param[in] fileName Name of the instance file
+ * @return false if one error occured, true otherwise
+ */
+bool loadInstance(string fileName)
+{
+    if (!readInstanceCached(fileName) || !checkObjectiveRange(fileName)) {
+        return false;
+    }
+    if (!computeLowerBound(lb_threads)) {
+        return false;
+    }
+    if (!quiet) {
+        cout << "objective : " << Objective::name() << ", lower bound : " << lowerBound << endl;
+    }
+    return true;
+}
+
 /**
  * Constructs the name of the output file according to the global parameters
  * 
@@ -29,8 +147,10 @@ bool getFileName(string & fileName)
     
     if (sls_global == ACO) {
         fileName += "aco/aco";
-    } else {
+    } else if (sls_global == ILS) {
         fileName += "ils/ils";
+    } else {
+        fileName += "ig/ig";
     }
 
     fileName += ".dat";
@@ -72,7 +192,7 @@ bool appendToFile(char * fileName, string message)
     ofstream myStream(myFile.c_str(), ios::app);
 
     if (myStream) {
-        myStream << message << endl;
+        myStream << message << '\n';
         return true;
     }
     else {
@@ -82,52 +202,126 @@ bool appendToFile(char * fileName, string message)
 }
 
 /**
- * Fill the given vectors with the names of the instances files and the names of the instances
+ * Convert a text instance into its binary image
  * 
- * @param[out] fileNames Names of the instances files
- * @param[out] instanceNames Names of the instances, useful to write it on the output files next to the BS and TIME
+ * @param[in] textName Name of the text instance
+ * @param[in] binaryName Name of the binary image to write
  * @return false if one error occured, true otherwise
  */
-bool fillFileNames(vector<string> & fileNames,vector<string> & instanceNames,int & nbFiles, vector<int> & targets, double & timeLimit)
+bool convertInstance(string textName, string binaryName)
 {
-    string s1 = "../instances/100_20_";
-    string s2 = "../instances/50_20_";
-    string n1 = "100_20_";
-    string n2 = "50_20_";
+    PfspInstance textInstance;
+    if (!textInstance.readDataFromFile(textName)) {
+        return false;
+    }
+    return textInstance.writeBinaryFile(binaryName);
+}
 
-    double coef = 1.005;
+/**
+ * Fill the given vectors with the names of the instances files matching a directory or a glob pattern
+ * 
+ * A directory stands for all its files. Binary sidecars (name.bin next to name) are skipped, the binary
+ * images without their text file are kept. Instances are only listed here, they are read when their runs start.
+ * 
+ * @param[in] pattern Directory or glob pattern, e.g. instances/100_20_*
+ * @param[out] fileNames Names of the instances files, sorted
+ * @param[out] instanceNames Names of the instances (file name without the directory), useful to write it on the output files next to the BS and TIME
+ * @param[out] nbFiles Number of instances found
+ * @return false if one error occured, true otherwise
+ */
+bool fillFileNames(string pattern, vector<string> & fileNames, vector<string> & instanceNames, int & nbFiles)
+{
+    struct stat patternStat;
+    if (stat(pattern.c_str(),&patternStat) == 0 && S_ISDIR(patternStat.st_mode)) {
+        pattern += "/*";
+    }
 
-    targets[0] = 595260;
-    targets[1] = 622342;
-    targets[2] = 592745;
-    targets[3] = 666621;
-    targets[4] = 653748;
+    glob_t globResult;
+    int status = glob(pattern.c_str(), 0, NULL, &globResult);
+    if (status != 0 && status != GLOB_NOMATCH) {
+        generateError("files.h","fillFileNames","glob failed","pattern",pattern);
+        return false;
+    }
 
-    for (int i = 0; i < 5; i ++) {
-        targets[i] = (int)ceil(targets[i]*coef);
+    vector<string> matches;
+    for (size_t i = 0; i < globResult.gl_pathc; i++) {
+        matches.push_back(globResult.gl_pathv[i]);
     }
+    globfree(&globResult);
 
-    timeLimit = 250*1000;
+    fileNames.clear();
+    instanceNames.clear();
+    string name;
+    struct stat fileStat;
+    for (size_t i = 0; i < matches.size(); i++) {
+        name = matches[i];
+        if (stat(name.c_str(),&fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+            continue;
+        }
+        if (name.size() > 4 && name.compare(name.size()-4,4,".bin") == 0
+            && binary_search(matches.begin(),matches.end(),name.substr(0,name.size()-4))) {
+            continue; /// cache of a listed text instance
+        }
+        fileNames.push_back(name);
+        instanceNames.push_back(name.substr(name.find_last_of('/')+1));
+    }
 
-    if (true){
-        nbFiles = 5;
+    nbFiles = fileNames.size();
+    if (nbFiles == 0) {
+        generateError("files.h","fillFileNames","no instance found","pattern",pattern);
+        return false;
+    }
+    return true;
+}
 
-        fileNames.resize(60);
-        instanceNames.resize(60);
+/**
+ * Read the targets of the instances from a manifest file
+ * 
+ * Each line of the manifest is "instance_name best_known coefficient", lines starting with # are comments.
+ * The target of an instance is ceil(best_known * coefficient); instances absent from the manifest have no target (0).
+ * 
+ * @param[in] manifestName Name of the manifest file, no target at all if empty
+ * @param[in] instanceNames Names of the instances of the experiment
+ * @param[out] targets Target of each instance
+ * @return false if one error occured, true otherwise
+ */
+bool readTargets(string manifestName, vector<string> & instanceNames, vector<int> & targets)
+{
+    targets.assign(instanceNames.size(), 0);
+    if (manifestName.empty()) {
+        return true;
+    }
 
-        fileNames[0] = "../instances/50_20_01";
-        fileNames[1] = "../instances/50_20_02";
-        fileNames[2] = "../instances/50_20_03";
-        fileNames[3] = "../instances/50_20_04";
-        fileNames[4] = "../instances/50_20_05";
+    ifstream manifest(manifestName);
+    if (!manifest.is_open()) {
+        generateError("files.h","readTargets","impossible to open the manifest","manifest",manifestName);
+        return false;
+    }
 
-        instanceNames[0] = "50_20_01";
-        instanceNames[1] = "50_20_02";
-        instanceNames[2] = "50_20_03";
-        instanceNames[3] = "50_20_04";
-        instanceNames[4] = "50_20_05";
+    map<string,int> targetOf;
+    string line;
+    string name;
+    double bestKnown;
+    double coef;
+    int lineNumber = 0;
+    while (getline(manifest,line)) {
+        lineNumber ++;
+        if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == string::npos) {
+            continue;
+        }
+        istringstream fields(line);
+        if (!(fields >> name >> bestKnown >> coef)) {
+            generateError("files.h","readTargets","malformed manifest line","line",lineNumber);
+            return false;
+        }
+        targetOf[name] = (int)ceil(bestKnown*coef);
     }
 
+    for (size_t i = 0; i < instanceNames.size(); i++) {
+        if (targetOf.count(instanceNames[i])) {
+            targets[i] = targetOf[instanceNames[i]];
+        }
+    }
     return true;
 }
 
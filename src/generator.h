@@ -0,0 +1,200 @@
+/*****************************************************************************
+ * Seeded generator of synthetic instances, in the format of the instances/  *
+ *****************************************************************************/
+
+#ifndef _GENERATOR_H_
+#define _GENERATOR_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <random>
+#include <cmath>
+#include <string.h>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "lowerBound.h"
+
+using namespace std;
+
+/// Parameters of a generated instance, the same parameters always give the same instance
+struct GeneratorParameters {
+    int nbJobs = 100;
+    int nbMachines = 20;
+    unsigned int generatorSeed = 1;
+    string distribution = "uniform"; /// uniform, job_correlated, machine_correlated or exponential
+    int minTime = 1;
+    int maxTime = 99;
+    int maxPriority = 10; /// priorities (weights) uniform in [1,maxPriority]
+    double dueFactor = 3.; /// due date of a job : its total processing time times (1 + dueFactor * U[0,1])
+};
+
+/**
+ * Uniform integer in [low,high], from the raw output of the generator
+ * (std distributions are implementation defined, this keeps the instances identical on every platform)
+ */
+int uniformInt(mt19937 & generator, int low, int high)
+{
+    return low + (int)(generator() % (unsigned int)(high - low + 1));
+}
+
+/// Uniform double in [0,1)
+double uniformDouble(mt19937 & generator)
+{
+    return generator() / 4294967296.;
+}
+
+/**
+ * Fill the global instance with a generated instance
+ *
+ * Processing times (clamped to [minTime,maxTime]) :
+ *      uniform : U[minTime,maxTime], as in Taillard's instances
+ *      job_correlated : each job has a base time, the times of the job stay within 20% of the range around it
+ *      machine_correlated : the same, around a base time per machine
+ *      exponential : exponential of mean (minTime+maxTime)/2
+ *
+ * @param[in] parameters Parameters of the instance
+ * @return false if one error occured, true otherwise
+ */
+bool generateInstance(GeneratorParameters & parameters)
+{
+    if (parameters.nbJobs < 1 || parameters.nbMachines < 1) {
+        generateError("generator.h","generateInstance","the numbers of jobs and machines should be positive","nbJobs",parameters.nbJobs);
+        return false;
+    }
+    if (parameters.minTime < 0 || parameters.maxTime < parameters.minTime || parameters.maxPriority < 1 || parameters.dueFactor < 0) {
+        generateError("generator.h","generateInstance","wrong ranges of times, priorities or due dates","maxTime",parameters.maxTime);
+        return false;
+    }
+    string & distribution = parameters.distribution;
+    if (distribution != "uniform" && distribution != "job_correlated" && distribution != "machine_correlated" && distribution != "exponential") {
+        generateError("generator.h","generateInstance","distribution not recognized","distribution",distribution);
+        return false;
+    }
+
+    mt19937 generator (parameters.generatorSeed);
+    int nbJobs = parameters.nbJobs;
+    int nbMachines = parameters.nbMachines;
+    int range = parameters.maxTime - parameters.minTime;
+    int spread = range / 10; /// correlated times : base +- 10% of the range
+
+    instance.allowMatrixMemory(nbJobs,nbMachines);
+
+    vector<int> machineBase (nbMachines+1);
+    for (int m = 1; m <= nbMachines; m++) {
+        machineBase[m] = uniformInt(generator,parameters.minTime,parameters.maxTime);
+    }
+    for (int j = 1; j <= nbJobs; j++) {
+        int jobBase = uniformInt(generator,parameters.minTime,parameters.maxTime);
+        long long total = 0;
+        for (int m = 1; m <= nbMachines; m++) {
+            int time;
+            if (distribution == "uniform") {
+                time = uniformInt(generator,parameters.minTime,parameters.maxTime);
+            } else if (distribution == "job_correlated") {
+                time = jobBase + uniformInt(generator,-spread,spread);
+            } else if (distribution == "machine_correlated") {
+                time = machineBase[m] + uniformInt(generator,-spread,spread);
+            } else {
+                time = (int)lround(-log(1. - uniformDouble(generator)) * (parameters.minTime + parameters.maxTime) / 2.);
+            }
+            time = max(parameters.minTime,min(parameters.maxTime,time));
+            instance.setTime(j,m,time);
+            total += time;
+        }
+        instance.setPriority(j,uniformInt(generator,1,parameters.maxPriority));
+        instance.setDueDate(j,(int)(total * (1. + parameters.dueFactor * uniformDouble(generator))));
+    }
+    solution.assign(nbJobs+1,0);
+    return true;
+}
+
+/**
+ * Write the global instance in the text format read by PfspInstance::readDataFromFile
+ *
+ * @param[in] fileName Name of the file, "-" for the standard output
+ * @return false if one error occured, true otherwise
+ */
+bool writeInstanceText(string fileName)
+{
+    stringstream text;
+    int nbJobs = instance.getNbJob();
+    int nbMachines = instance.getNbMac();
+    int value;
+    text << nbJobs << " " << nbMachines << "\n";
+    for (int j = 1; j <= nbJobs; j++) {
+        for (int m = 1; m <= nbMachines; m++) {
+            instance.getTime(j,m,value);
+            text << m << " " << value << " ";
+        }
+        text << "\n";
+    }
+    text << "Reldue\n";
+    for (int j = 1; j <= nbJobs; j++) {
+        instance.getPriority(j,value);
+        text << "-1 " << instance.getDueDate(j) << " -1 " << value << "\n";
+    }
+
+    if (fileName == "-") {
+        cout << text.rdbuf();
+        return true;
+    }
+    ofstream instanceStream(fileName);
+    if (!instanceStream) {
+        generateError("generator.h","writeInstanceText","impossible to open a file","file_name",fileName);
+        return false;
+    }
+    instanceStream << text.rdbuf();
+    if (!instanceStream) {
+        generateError("generator.h","writeInstanceText","impossible to write the instance","file_name",fileName);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Generation mode : ./main --generate <file|-> --jobs <n> --machines <m> [--seed <s>] [--distribution <name>]
+ *                          [--min_time <t>] [--max_time <t>] [--max_priority <w>] [--due_factor <f>]
+ *
+ * @return the exit status : 0 if the instance was written, 1 otherwise
+ */
+int runGenerator(int argc, char * argv[])
+{
+    GeneratorParameters parameters;
+    string fileName = argv[2];
+    for (int i = 3; i < argc; i++) {
+        if (i+1 >= argc) {
+            generateError("generator.h","runGenerator","missing value","argument",argv[i]);
+            return 1;
+        }
+        if (strcmp(argv[i],"--jobs") == 0) {
+            parameters.nbJobs = atoi(argv[++i]);
+        } else if (strcmp(argv[i],"--machines") == 0) {
+            parameters.nbMachines = atoi(argv[++i]);
+        } else if (strcmp(argv[i],"--seed") == 0) {
+            parameters.generatorSeed = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i],"--distribution") == 0) {
+            parameters.distribution = argv[++i];
+        } else if (strcmp(argv[i],"--min_time") == 0) {
+            parameters.minTime = atoi(argv[++i]);
+        } else if (strcmp(argv[i],"--max_time") == 0) {
+            parameters.maxTime = atoi(argv[++i]);
+        } else if (strcmp(argv[i],"--max_priority") == 0) {
+            parameters.maxPriority = atoi(argv[++i]);
+        } else if (strcmp(argv[i],"--due_factor") == 0) {
+            parameters.dueFactor = atof(argv[++i]);
+        } else {
+            generateError("generator.h","runGenerator","argument not recognized","argument",argv[i]);
+            return 1;
+        }
+    }
+    /// an instance the solver would refuse (see checkObjectiveRange) is not written
+    if (!generateInstance(parameters) || !checkObjectiveRange(fileName) || !writeInstanceText(fileName)) {
+        return 1;
+    }
+    return 0;
+}
+
+#endif
@@ -8,6 +8,8 @@
 
 #include <iostream>
 #include <vector>
+#include <chrono>
+#include <atomic>
 
 #include "pfspinstance.h"
 
@@ -20,24 +22,80 @@ enum Initial_solution   { Random_permutation, Simplified_RZ };
 enum Algorithm          { II, VND };
 enum Neighborhood_order { tr_ex_in, tr_in_ex };
 
-enum SLS                { ACO, ILS };
+enum SLS                { ACO, ILS, IG };
 
 /***********************************
  * Global parameters and variables *
  ***********************************/
 
-Pivoting_rule pivoting_rule;
-Neighborhood neighborhood;
-Initial_solution initial_solution;
-Algorithm algorithm;
-Neighborhood_order neighborhood_order;
+/// the state of a run is thread_local : several runs can be executed concurrently, one per thread (see experiment.h)
+thread_local Pivoting_rule pivoting_rule;
+thread_local Neighborhood neighborhood;
+thread_local Initial_solution initial_solution;
+thread_local Algorithm algorithm;
+thread_local Neighborhood_order neighborhood_order;
 char * instance_file = NULL;
-bool experiment = false;
-
-SLS sls_global;
-PfspInstance instance;
-vector<int> solution;
-int WCT;
+thread_local bool experiment = false;
+int experiment_threads = 1; /// threads executing the runs of an experiment concurrently
+string journal_file = ""; /// progress journal of the experiment campaign (see campaign.h), empty for none
+int shard_index = 0; /// this process executes the runs of the campaign whose index is shard_index modulo shard_count
+int shard_count = 1;
+bool scaling = false; /// scaling benchmark mode (see scaling.h)
+string scaling_output = "scaling.json"; /// measures of the scaling benchmark, JSON
+
+thread_local SLS sls_global;
+thread_local PfspInstance instance;
+thread_local vector<int> solution;
+thread_local int WCT;
+
+thread_local double max_evaluations = 0.; /// evaluation budget in work units, 0 means no budget
+thread_local chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max(); /// wall clock deadline of the current run
+atomic<int> cancelGeneration (0); /// incremented by each cancellation, can be done from a signal handler or another thread
+thread_local int runGeneration = 0; /// value of cancelGeneration when the current run started
+thread_local bool runStopped = false; /// the current run met its deadline or was cancelled
+
+thread_local long long lowerBound = 0; /// lower bound of the instance, computed at load
+double target_gap = -1.; /// the heuristics stop once the gap to lowerBound is below target_gap (%), negative means no gap
+int lb_threads = 1; /// number of threads computing the lower bound
+bool use_instance_cache = true; /// text instances are cached in a binary sidecar file (instance_file.bin)
+
+thread_local unsigned int seed = 1; /// seed of the random generator of the current run
+string results_file = ""; /// results sink (see results.h), CSV or JSONL, empty for none
+string trace_file = ""; /// anytime trace of the improvements (see trace.h), empty for none
+bool quiet = false; /// no console output during the runs
+string phase_trace_file = ""; /// Chrome trace of the phases of the heuristics (see phases.h), empty for none
+bool latency_report = false; /// latency histograms printed at the end of each run (see histogram.h)
+bool cpu_time = false; /// time limits and times to best in CPU time of the thread running the heuristic instead of wall time (see budget.h)
+string checkpoint_file = ""; /// checkpoint of the ACO/ILS run (see checkpoint.h), empty for none
+double checkpoint_period = 60*1000.; /// ms between two checkpoints
+string initial_solution_file = ""; /// permutation the heuristics start from (--initial_solution), "-" for the standard input, empty for none
+string edits_file = ""; /// edits of the instance applied during the run (see edits.h), empty for none
+string store_directory = ""; /// store of the best known solutions (see store.h), empty for none
+int store_elite = 1; /// number of best distinct solutions kept per instance in the store
+string stats_format = ""; /// statistics printed at the end of each run (see stats.h) : "text", "json", or empty for none
+int serve_workers = 1; /// threads of the solver daemon solving the requests concurrently (see serve.h)
+int serve_queue = 64; /// requests waiting for a worker of the solver daemon, the readers block beyond
+
+/// parameters of the heuristics given by a request of the solver daemon (see serve.h), negative values keep the defaults
+struct HeuristicParameters {
+    double rho = -1.; /// ACO
+    int max_iterations = -1;
+    int nbPerturbationSteps = -1; /// ILS
+    double lambda = -1.; /// ILS and IG
+    int nbDestructions = -1; /// IG
+};
+thread_local HeuristicParameters parameterOverrides;
+
+/// result of the last run of a heuristic, filled at its end
+struct RunResult {
+    vector<int> bestSol;
+    int bestWCT = 0;
+    double timeToBest = 0.; /// ms, CPU time with cpu_time
+    double time = 0.; /// wall time, ms
+    double cpuTime = 0.; /// CPU time of the thread that executed the run, ms
+    double evaluations = 0.;
+};
+thread_local RunResult lastRun;
 
 int argc_global;
 vector<string> argv_global;
@@ -108,6 +166,7 @@ std::ostream& operator<<(std::ostream& out, const SLS value){
     switch(value){
         PROCESS_VAL(ACO);     
         PROCESS_VAL(ILS);
+        PROCESS_VAL(IG);
     }
     #undef PROCESS_VAL
     return out << s;
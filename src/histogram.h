@@ -0,0 +1,219 @@
+/*****************************************************************************
+ * Latency histograms (HDR-style, log-linear buckets) and percentile report  *
+ *****************************************************************************/
+
+#ifndef _HISTOGRAM_H_
+#define _HISTOGRAM_H_
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <mutex>
+
+#include "globalVariables.h"
+
+using namespace std;
+
+/// each power of two is split in 2^HISTOGRAM_SUB_BITS buckets : values are known within 1/32 (about 3%)
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+/// values up to 2^62 ns
+#define HISTOGRAM_NB_BUCKETS ((62 - HISTOGRAM_SUB_BITS + 2) * HISTOGRAM_SUB_COUNT)
+
+struct LatencyHistogram {
+    long long counts[HISTOGRAM_NB_BUCKETS];
+    long long total; /// number of recorded values
+    long long max; /// exact maximum, ns
+};
+
+thread_local LatencyHistogram vndLatency; /// per call of embeddedVND
+thread_local LatencyHistogram iterationLatency; /// per iteration of the main loop of the SLS
+thread_local LatencyHistogram constructionLatency; /// per construction (ACO) or reconstruction (IG)
+
+/// the same histograms, merged over all the runs (and threads) of an experiment
+LatencyHistogram allVndLatency;
+LatencyHistogram allIterationLatency;
+LatencyHistogram allConstructionLatency;
+mutex allLatenciesMutex;
+
+/**
+ * Bucket of a value : the values below HISTOGRAM_SUB_COUNT have their own bucket, the others share
+ * HISTOGRAM_SUB_COUNT buckets per power of two
+ * 
+ * @param[in] value Latency in ns, non negative
+ * @return the index of its bucket
+ */
+inline int histogramBucket(long long value)
+{
+    if (value < HISTOGRAM_SUB_COUNT) {
+        return value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - HISTOGRAM_SUB_BITS;
+    return (shift + 1) * HISTOGRAM_SUB_COUNT + (int)((value >> shift) - HISTOGRAM_SUB_COUNT);
+}
+
+/**
+ * Highest value of a bucket
+ * 
+ * @param[in] bucket Index of the bucket
+ * @return the highest value, ns, falling in this bucket
+ */
+long long histogramBucketValue(int bucket)
+{
+    if (bucket < HISTOGRAM_SUB_COUNT) {
+        return bucket;
+    }
+    int shift = bucket / HISTOGRAM_SUB_COUNT - 1;
+    long long sub = bucket % HISTOGRAM_SUB_COUNT + HISTOGRAM_SUB_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+void resetHistogram(LatencyHistogram & histogram)
+{
+    for (int i = 0; i < HISTOGRAM_NB_BUCKETS; i++) {
+        histogram.counts[i] = 0;
+    }
+    histogram.total = 0;
+    histogram.max = 0;
+}
+
+/**
+ * Record a latency, in constant time
+ * 
+ * @param[in,out] histogram The histogram
+ * @param[in] value Latency in ns
+ */
+inline void recordLatency(LatencyHistogram & histogram, long long value)
+{
+    if (value < 0) {
+        value = 0;
+    }
+    if (value >= (1LL << 62)) {
+        value = (1LL << 62) - 1;
+    }
+    histogram.counts[histogramBucket(value)] ++;
+    histogram.total ++;
+    if (value > histogram.max) {
+        histogram.max = value;
+    }
+}
+
+/**
+ * Add the values of a histogram to another one (other runs, other threads)
+ * 
+ * @param[in,out] into The histogram receiving the values
+ * @param[in] from The histogram to add
+ */
+void mergeHistogram(LatencyHistogram & into, LatencyHistogram & from)
+{
+    for (int i = 0; i < HISTOGRAM_NB_BUCKETS; i++) {
+        into.counts[i] += from.counts[i];
+    }
+    into.total += from.total;
+    if (from.max > into.max) {
+        into.max = from.max;
+    }
+}
+
+/**
+ * Value below which the given fraction of the recorded values fall
+ * 
+ * @param[in] histogram The histogram
+ * @param[in] fraction In [0,1], e.g. 0.99 for p99
+ * @return the percentile in ns (upper bound of its bucket, never above the maximum)
+ */
+long long histogramPercentile(LatencyHistogram & histogram, double fraction)
+{
+    if (histogram.total == 0) {
+        return 0;
+    }
+    long long rank = (long long)(fraction * histogram.total + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    long long seen = 0;
+    for (int i = 0; i < HISTOGRAM_NB_BUCKETS; i++) {
+        seen += histogram.counts[i];
+        if (seen >= rank) {
+            return min(histogramBucketValue(i), histogram.max);
+        }
+    }
+    return histogram.max;
+}
+
+/**
+ * Times the scope it is declared in into a histogram, when the latencies are reported (latency_report)
+ */
+struct ScopedLatency {
+    LatencyHistogram & histogram;
+    bool active;
+    chrono::steady_clock::time_point begin;
+
+    ScopedLatency(LatencyHistogram & target) : histogram(target), active(latency_report)
+    {
+        if (active) {
+            begin = chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedLatency()
+    {
+        if (active) {
+            recordLatency(histogram, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count());
+        }
+    }
+};
+
+/**
+ * Empty the histograms of the run, at its beginning
+ */
+void resetLatencies()
+{
+    resetHistogram(vndLatency);
+    resetHistogram(iterationLatency);
+    resetHistogram(constructionLatency);
+}
+
+/**
+ * Add the histograms of the run that just ended (on the calling thread) to the ones of the experiment
+ */
+void mergeLatencies()
+{
+    lock_guard<mutex> lock(allLatenciesMutex);
+    mergeHistogram(allVndLatency, vndLatency);
+    mergeHistogram(allIterationLatency, iterationLatency);
+    mergeHistogram(allConstructionLatency, constructionLatency);
+}
+
+void printHistogramLine(const char * name, LatencyHistogram & histogram)
+{
+    cout << "   " << left << setw(14) << name << right << setw(10) << histogram.total;
+    double percentiles[4] = {0.5, 0.9, 0.99, 1.};
+    for (int k = 0; k < 4; k++) {
+        long long value = k < 3 ? histogramPercentile(histogram, percentiles[k]) : histogram.max;
+        cout << setw(12) << fixed << setprecision(3) << value/1e6;
+    }
+    cout << defaultfloat << setprecision(6) << "\n";
+}
+
+/**
+ * Print p50/p90/p99/max of the given histograms, in ms
+ * 
+ * @param[in] title Title of the report
+ * @param[in] vnd Latencies of embeddedVND
+ * @param[in] iteration Latencies of the iterations
+ * @param[in] construction Latencies of the constructions
+ */
+void printLatencies(string title, LatencyHistogram & vnd, LatencyHistogram & iteration, LatencyHistogram & construction)
+{
+    cout << "Latencies (" << title << ", ms):\n"
+         << "   " << left << setw(14) << "" << right << setw(10) << "count" << setw(12) << "p50" << setw(12) << "p90"
+         << setw(12) << "p99" << setw(12) << "max" << "\n";
+    printHistogramLine("embeddedVND", vnd);
+    printHistogramLine("iteration", iteration);
+    printHistogramLine("construction", construction);
+    cout << endl;
+}
+
+#endif
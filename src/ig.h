@@ -0,0 +1,202 @@
+#ifndef _IG_H_
+#define _IG_H_
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+#include "errors.h"
+#include "parameters.h"
+#include "localSearch.h"
+#include "store.h"
+#include "ils.h"
+
+/**
+ * Remove nbDestructions random jobs from a copy of currentSol
+ * 
+ * @param[in] nbDestructions Number of jobs to remove
+ * @param[in] currentSol Solution to destruct
+ * @param[out] partialSol The remaining jobs, in partialSol[1:nbJob-nbDestructions]
+ * @param[out] removedJobs The removed jobs, in removedJobs[1:nbDestructions], in the order they were removed
+ * @return false if one error occured, true otherwise
+ */
+bool destructSolution(int & nbDestructions, vector<int> & currentSol, vector<int> & partialSol, vector<int> & removedJobs) {
+    ScopedPhase phase("destructSolution");
+    if (nbDestructions < 1 || nbDestructions >= instance.getNbJob()) {
+        generateError("ig.h","destructSolution","nbDestructions out of range","nbDestructions",nbDestructions);
+        return false;
+    }
+    if (!replaceSolByNewSol(partialSol,currentSol)) { return false; }
+    int nbRemaining = instance.getNbJob();
+    int position;
+    for (int k = 1; k <= nbDestructions; k++) {
+        position = randomInt()%nbRemaining+1;
+        removedJobs[k] = partialSol[position];
+        for (int x = position; x < nbRemaining; x++) {
+            partialSol[x] = partialSol[x+1];
+        }
+        nbRemaining --;
+    }
+    return true;
+}
+
+/**
+ * Reinsert the removed jobs one by one, each at its best position (same greedy insertion as simplifiedRZ)
+ * 
+ * @param[in] nbDestructions Number of removed jobs
+ * @param[in] removedJobs The removed jobs, reinserted in this order
+ * @param[in,out] partialSol The partial solution, complete at the end
+ * @param[out] wct WCT of the reconstructed solution
+ * @return false if one error occured, true otherwise
+ */
+bool reconstructSolution(int & nbDestructions, vector<int> & removedJobs, vector<int> & partialSol, int & wct) {
+    ScopedPhase phase("reconstructSolution");
+    ScopedLatency latency(constructionLatency);
+    int nbRemaining = instance.getNbJob() - nbDestructions;
+    for (int k = 1; k <= nbDestructions; k++) {
+        if (!constructSolMinWCT(nbRemaining,removedJobs[k],partialSol)) { return false; }
+        nbRemaining ++;
+    }
+    return Objective::evaluate(instance.getNbJob(),partialSol,wct);
+}
+
+/**
+ * Operate an iterated greedy (destruction - reconstruction) on the instance
+ * 
+ * Each iteration removes nbDestructions random jobs from the current solution, reinserts them at their best positions,
+ * operates a VND on the result, and accepts it with the same temperature criterion as the ILS.
+ * 
+ * @param[in] readParams Wether or not the function has to parse the command parameters (false for the experiments)
+ * @param[in] target Target solution quality, termination criteria
+ * @param[in] timeLimit Termination criteria, ms
+ * @return false if one error occured, true otherwise
+ */
+bool IG_heuristic(bool & readParams, int & target, double & timeLimit) {
+
+    auto start = chrono::high_resolution_clock::now();
+    auto end = chrono::high_resolution_clock::now();
+    chrono::duration<double, std::milli> ms_double;
+
+    int nbDestructions = 4;
+    int max_iterations = 50;
+    double lambda = 0.4;
+
+    vector<int> bestSolEver;
+    vector<int> currentSol;
+    vector<int> greedySol;
+    vector<int> removedJobs;
+
+    int bestWCTEver;
+    int currentWCT;
+    int greedyWCT;
+
+    if (readParams) {
+        if (!readIGArguments(nbDestructions,max_iterations,lambda)) { return false; }
+    } else {
+        setDefaultIGParameters(nbDestructions,max_iterations,lambda);
+    }
+
+    if (nbDestructions >= instance.getNbJob()) {
+        nbDestructions = instance.getNbJob()-1;
+    }
+
+    int sumTimes = 0;
+    int timeBuffer;
+    double randomDouble;
+
+    for (int job = 1; job <= instance.getNbJob(); job ++) {
+        for (int mac = 1; mac <= instance.getNbMac(); mac ++) {
+            instance.getTime(job,mac,timeBuffer);
+            sumTimes += timeBuffer;
+        }
+    }
+
+    double temperature = lambda*((sumTimes)/(10*instance.getNbJob()*instance.getNbMac()));
+
+    resizeMatrix(bestSolEver,currentSol,greedySol);
+    removedJobs.resize(nbDestructions+1);
+    startBudget(timeLimit);
+    resetStats();
+    resetLatencies();
+
+    // INITIAL SOLUTION
+    if (!initialSolution(bestSolEver,bestWCTEver)) { return false; }
+
+    end = chrono::high_resolution_clock::now();
+    ms_double = end - start;
+    double timeToBest = runTime(ms_double.count());
+    startTrace();
+    recordImprovement(timeToBest,0,bestWCTEver);
+
+    replaceSolByNewSol(currentSol,bestSolEver);
+
+    currentWCT = bestWCTEver;
+
+    int iteration = 1;
+    bool termination = false;
+
+    while (!termination) {
+        ScopedLatency latency(iterationLatency);
+        // Destruction - reconstruction
+        if (!destructSolution(nbDestructions,currentSol,greedySol,removedJobs)) { return false; }
+        if (!reconstructSolution(nbDestructions,removedJobs,greedySol,greedyWCT)) { return false; }
+
+        // Local search (VND)
+        embeddedVND(greedySol,greedyWCT);
+
+        // Acceptance
+        if (greedyWCT < currentWCT) {
+            STAT_INC(improvingAcceptances);
+            if (!replaceSolByNewSol(currentSol,greedySol)) {return false;}
+            currentWCT = greedyWCT;
+            if (greedyWCT < bestWCTEver) {
+                if (!replaceSolByNewSol(bestSolEver,greedySol)) {return false;}
+                bestWCTEver = greedyWCT;
+
+                end = chrono::high_resolution_clock::now();
+                ms_double = end - start;
+
+                timeToBest = runTime(ms_double.count());
+                recordImprovement(timeToBest,iteration,bestWCTEver);
+                if (!quiet) {
+                    cout << "new best : " << bestWCTEver << ", it : " << iteration << ", time = " << ms_double.count()/1000. << "s, evaluations = " << instance.getNbEvaluations() << ", gap = " << formatGap(bestWCTEver) << '\n';
+                }
+            }
+        } else { // Non improving solution
+            randomDouble = (double) randomInt() / (RAND_MAX);
+            if (randomDouble <= exp((currentWCT - greedyWCT)/temperature)) {
+                STAT_INC(worseningAcceptances);
+                if (!replaceSolByNewSol(currentSol,greedySol)) {return false;}
+                currentWCT = greedyWCT;
+            } else {
+                STAT_INC(rejections);
+            }
+        }
+
+        iteration ++;
+        end = chrono::high_resolution_clock::now();
+        ms_double = end - start;
+
+        // Test if the algorithm should stop
+        if (!updateILSTermination(iteration,max_iterations,ms_double,bestWCTEver,target,timeLimit,termination)) { return false; }
+    }
+
+    end = chrono::high_resolution_clock::now();
+    ms_double = end - start;
+    saveRunResult(bestSolEver,bestWCTEver,timeToBest,ms_double.count());
+    if (!stats_format.empty()) {
+        printStats(ms_double.count());
+    }
+    if (latency_report) {
+        printLatencies("run",vndLatency,iterationLatency,constructionLatency);
+    }
+
+    if (!quiet) {
+        cout << "best : " << bestWCTEver << ", lower bound = " << lowerBound << ", gap = " << formatGap(bestWCTEver) << ", wall time = " << lastRun.time/1000. << "s, cpu time = " << lastRun.cpuTime/1000. << "s" << endl;
+    }
+
+    return true;
+}
+
+#endif
@@ -10,6 +10,8 @@
 #include "errors.h"
 #include "parameters.h"
 #include "localSearch.h"
+#include "store.h"
+#include "checkpoint.h"
 
 void resizeMatrix(vector<int> & bestSolEver, vector<int> & currentSol, vector<int> & perturbSol) {
     bestSolEver.resize(instance.getNbJob()+1);
@@ -22,7 +24,7 @@ void resizeMatrix(vector<int> & bestSolEver, vector<int> & currentSol, vector<in
  * 
  * @param[in] iteration Number of the current iteration
  * @param[in] max_iterations Maximum number of iterations
- * @param[out] result True if the algorithm should stop, false otherwise
+ * @param[out] result True if the algorithm should stop (including when the evaluation budget, the deadline or a cancellation stopped the search, or when the gap to the lower bound is small enough), false otherwise
  * @return false if one error occured, true otherwise
  */
 bool updateILSTermination(int & iteration, int & max_iterations, chrono::duration<double, std::milli> & ms_double, int bestWCTever, int & target, double & timeLimit, bool & termination) {
@@ -41,7 +43,13 @@ bool updateILSTermination(int & iteration, int & max_iterations, chrono::duratio
     if (bestWCTever <= target) {
         termination = true;
     }
-    if (ms_double.count() > timeLimit){
+    if (runTime(ms_double.count()) > timeLimit){
+        termination = true;
+    }
+    if (stopRequested()) {
+        termination = true;
+    }
+    if (gapReached(bestWCTever)) {
         termination = true;
     }
     return true;
@@ -56,12 +64,13 @@ bool updateILSTermination(int & iteration, int & max_iterations, chrono::duratio
  * @return false if one error occured, true otherwise
  */
 bool perturbSolution(int & nbPerturbationSteps, vector<int> & currentSol, vector<int> & perturbSol) {
+    ScopedPhase phase("perturbSolution");
     replaceSolByNewSol(perturbSol,currentSol);
     int insertBegin;
     int insertEnd;
     for (int i = 1; i <= nbPerturbationSteps; i++) {
-        insertBegin = round(rand()%(instance.getNbJob())+1);
-        insertEnd = round(rand()%(instance.getNbJob())+1);
+        insertBegin = round(randomInt()%(instance.getNbJob())+1);
+        insertEnd = round(randomInt()%(instance.getNbJob())+1);
         if (!operateInsert(insertBegin,insertEnd,perturbSol,perturbSol,false)) {return false;}
     }
     return true;
@@ -113,21 +122,84 @@ bool ILS_heuristic(bool & readParams, int & target, double & timeLimit) {
 
     double temperature = lambda*((sumTimes)/(10*instance.getNbJob()*instance.getNbMac()));
 
-    resizeMatrix(bestSolEver,currentSol,perturbSol);
-
-    // INITIAL SOLUTION
-    simplifiedRZ(bestSolEver,bestWCTEver);
-    embeddedVND(bestSolEver,bestWCTEver);
-
-    replaceSolByNewSol(currentSol,bestSolEver);
+    Checkpoint checkpoint;
+    bool resumed = false;
+    bool checkpointing = !checkpoint_file.empty();
+    if (!loadCheckpoint("ILS",checkpoint,resumed)) { return false; }
 
-    currentWCT = bestWCTEver;
+    resizeMatrix(bestSolEver,currentSol,perturbSol);
+    startBudget(timeLimit);
+    resetStats();
+    resetLatencies();
 
     int iteration = 1;
     int stagnate = 0;
     bool termination = false;
+    double timeToBest;
+
+    if (resumed) {
+        // STATE OF THE CHECKPOINT
+        bestSolEver = checkpoint.bestSol;
+        bestWCTEver = checkpoint.bestWCT;
+        currentSol = checkpoint.currentSol;
+        currentWCT = checkpoint.currentWCT;
+        temperature = checkpoint.temperature;
+        iteration = checkpoint.iteration;
+        stagnate = checkpoint.stagnate;
+        timeToBest = checkpoint.timeToBest;
+        restoreRandom(checkpoint.random);
+        resumeBudget(checkpoint.wallTime,checkpoint.cpuTime,checkpoint.evaluations);
+        start -= chrono::duration_cast<chrono::high_resolution_clock::duration>(chrono::duration<double, std::milli>(checkpoint.wallTime));
+        startTrace();
+        recordImprovement(timeToBest,iteration,bestWCTEver);
+    } else {
+        // INITIAL SOLUTION
+        if (!initialSolution(bestSolEver,bestWCTEver)) { return false; }
+
+        end = chrono::high_resolution_clock::now();
+        ms_double = end - start;
+        timeToBest = runTime(ms_double.count());
+        startTrace();
+        recordImprovement(timeToBest,0,bestWCTEver);
+
+        replaceSolByNewSol(currentSol,bestSolEver);
+
+        currentWCT = bestWCTEver;
+    }
 
     while (!termination) {
+        ScopedLatency latency(iterationLatency);
+
+        if (!edits_file.empty()) {
+            // REPAIR AFTER EDITS OF THE INSTANCE
+            vector<int> jobMap;
+            vector<int> addedJobs;
+            bool edited;
+            if (!pollEdits(jobMap,addedJobs,edited)) { return false; }
+            if (edited) {
+                if (!repairSolution(bestSolEver,bestWCTEver,jobMap,addedJobs)) { return false; }
+                if (!repairSolution(currentSol,currentWCT,jobMap,addedJobs)) { return false; }
+                perturbSol.resize(instance.getNbJob()+1);
+                if (!quiet) {
+                    cout << "repaired best : " << bestWCTEver << ", current : " << currentWCT << ", it : " << iteration << '\n';
+                }
+            }
+        }
+
+        if (checkpointing && checkpointDue(checkpoint)) {
+            ms_double = chrono::high_resolution_clock::now() - start;
+            captureCheckpoint("ILS",ms_double.count(),timeToBest,checkpoint);
+            checkpoint.bestSol = bestSolEver;
+            checkpoint.bestWCT = bestWCTEver;
+            checkpoint.currentSol = currentSol;
+            checkpoint.currentWCT = currentWCT;
+            checkpoint.temperature = temperature;
+            checkpoint.iteration = iteration;
+            checkpoint.stagnate = stagnate;
+            checkpoint.lastWCT = 0;
+            checkpoint.pheromones.assign(1,vector<double>());
+            if (!periodicCheckpoint(checkpoint)) { return false; }
+        }
         // Adaptative number of perturbation steps
         if (stagnate <= 5000/(float)instance.getNbJob()){
             nbPerturbationSteps = 2;
@@ -146,13 +218,14 @@ bool ILS_heuristic(bool & readParams, int & target, double & timeLimit) {
 
         // Perturb solution
         if (!perturbSolution(nbPerturbationSteps,currentSol,perturbSol)) { return false; }
-        instance.computeWCT(instance.getNbJob(),perturbSol,perturbWCT);
+        Objective::evaluate(instance.getNbJob(),perturbSol,perturbWCT);
 
         // Local search (VND)
         embeddedVND(perturbSol,perturbWCT);
 
         // Router
         if (perturbWCT < currentWCT) {
+            STAT_INC(improvingAcceptances);
             if (!replaceSolByNewSol(currentSol,perturbSol)) {return false;}
             currentWCT = perturbWCT;
             if (perturbWCT < bestWCTEver) {
@@ -162,17 +235,24 @@ bool ILS_heuristic(bool & readParams, int & target, double & timeLimit) {
                 end = chrono::high_resolution_clock::now();
                 ms_double = end - start;
 
-                cout << "new best : " << perturbWCT << ", it : " << iteration << ", stagnate = "<<stagnate<<", time = " << ms_double.count()/1000. << "s" << endl;
+                timeToBest = runTime(ms_double.count());
+                recordImprovement(timeToBest,iteration,bestWCTEver);
+                if (!quiet) {
+                    cout << "new best : " << perturbWCT << ", it : " << iteration << ", stagnate = "<<stagnate<<", time = " << ms_double.count()/1000. << "s, evaluations = " << instance.getNbEvaluations() << ", gap = " << formatGap(bestWCTEver) << '\n';
+                }
                 
                 stagnate = 0;
             }
         } else { // Non improving solution
             stagnate ++;
 
-            randomDouble = (double) rand() / (RAND_MAX);
+            randomDouble = (double) randomInt() / (RAND_MAX);
             if (randomDouble <= exp((currentWCT - perturbWCT)/temperature)) {
+                STAT_INC(worseningAcceptances);
                 if (!replaceSolByNewSol(currentSol,perturbSol)) {return false;}
                 currentWCT = perturbWCT;
+            } else {
+                STAT_INC(rejections);
             }
         }
 
@@ -181,7 +261,23 @@ bool ILS_heuristic(bool & readParams, int & target, double & timeLimit) {
         ms_double = end - start;
 
         // Test if the algorithm should stop
-        updateILSTermination(iteration,max_iterations,ms_double,bestWCTEver,target,timeLimit,termination);
+        if (!updateILSTermination(iteration,max_iterations,ms_double,bestWCTEver,target,timeLimit,termination)) { return false; }
+    }
+
+    if (checkpointing && !finishCheckpoint(checkpoint)) { return false; }
+
+    end = chrono::high_resolution_clock::now();
+    ms_double = end - start;
+    saveRunResult(bestSolEver,bestWCTEver,timeToBest,ms_double.count());
+    if (!stats_format.empty()) {
+        printStats(ms_double.count());
+    }
+    if (latency_report) {
+        printLatencies("run",vndLatency,iterationLatency,constructionLatency);
+    }
+
+    if (!quiet) {
+        cout << "best : " << bestWCTEver << ", lower bound = " << lowerBound << ", gap = " << formatGap(bestWCTEver) << ", wall time = " << lastRun.time/1000. << "s, cpu time = " << lastRun.cpuTime/1000. << "s" << endl;
     }
 
     return true;
@@ -21,7 +21,7 @@
 #ifndef _PROJECT_1_H_
 #define _PROJECT_1_H_
 
-#include <iostream>      /// rand()
+#include <iostream>
 #include <vector>
 #include <float.h>       /// max value for floats and doubles
 #include <chrono>        /// measuring times
@@ -32,6 +32,14 @@
 #include "errors.h" /// functions to print errors, and help
 #include "parameters.h" /// functions to manage parameters parsing, setting and printing
 #include "files.h" /// functions to read, write, manage files
+#include "budget.h" /// evaluation budget, deadline and cancellation of a run
+#include "objective.h" /// objective function chosen at compile time
+#include "results.h" /// results of the runs, written by a dedicated thread
+#include "trace.h" /// anytime trace of the improvements
+#include "stats.h" /// solver counters
+#include "phases.h" /// scoped phase timers
+#include "histogram.h" /// latency histograms
+#include "random.h" /// random generator, one per thread
 
 using namespace std;
 
@@ -61,7 +69,7 @@ bool randomPermutation()
 
     nbj = 0;
     for (i = nbJobs; i >= 1; --i) {
-        rnd = rand() % i + 1;
+        rnd = randomInt() % i + 1;
         nbFalse = 0;
 
         /// find the rndth cell with value = false
@@ -80,7 +88,7 @@ bool randomPermutation()
     }
 
     /// update global WCT according to the new global solution found
-    if (!instance.computeWCT(nbJobs,solution,WCT)) {
+    if (!Objective::evaluate(nbJobs,solution,WCT)) {
         return false;
     }
 
@@ -117,6 +125,7 @@ bool replaceSolByNewSol(vector<int> & solToReplace, vector<int> & newSol)
  * @param[in] nbJobs The initial number of jobs in minSol
  * @param[in] newJob The id of the new job, that we'll add to minSol
  * @param[in,out] minSol The solution to which we'll add the new job, and become the best new solution.
+ *                       If stopRequested(), the best position found so far is kept.
  * @return false if one error occured, true otherwise
  */
 bool constructSolMinWCT(int nbJobs, int newJob, vector<int> & minSol)
@@ -124,11 +133,26 @@ bool constructSolMinWCT(int nbJobs, int newJob, vector<int> & minSol)
     /// initialization : we add the new job at the end of the permutation sequence and compute the new WCT
     //vector< int > sol (minSol); /// original solution sotred, to keep track of it
     minSol[nbJobs+1] = newJob; /// we add the new job at the end
+    if (stopRequested()) { /// no time left, the new job stays at the end
+        return true;
+    }
+    if (Objective::hasAcceleratedInsertion) { /// all the positions are evaluated at once
+        int position;
+        int value;
+        if (!Objective::bestInsertion(nbJobs,minSol,newJob,position,value)) {
+            return false;
+        }
+        for (int i = nbJobs+1; i > position; i--) {
+            minSol[i] = minSol[i-1];
+        }
+        minSol[position] = newJob;
+        return true;
+    }
     vector<int> solBuffer (minSol);
     
     /// computing the value of WCT for minSol
     int minWCT = 0;
-    if (!instance.computeWCT(nbJobs+1,minSol,minWCT)) {
+    if (!Objective::evaluate(nbJobs+1,minSol,minWCT)) {
         return false;
     }
 
@@ -136,7 +160,7 @@ bool constructSolMinWCT(int nbJobs, int newJob, vector<int> & minSol)
     int wctBuffer = 0;
     /// beginning minimization
     //for (int i = 1; i <= nbJobs; i++) {
-    for (int i = nbJobs; i >= 1; i --) {
+    for (int i = nbJobs; i >= 1 && !stopRequested(); i --) {
         /// we copy the first part of the sol unchanged into solBuffer
         /*for (int j = 1; j < i; j++) {
             solBuffer[j] = sol[j];
@@ -150,7 +174,7 @@ bool constructSolMinWCT(int nbJobs, int newJob, vector<int> & minSol)
         solBuffer[i+1] = solBuffer[i];
         solBuffer[i] = newJob;
         /// compute WCT of the buffer solution
-        if (!instance.computeWCT(nbJobs+1,solBuffer,wctBuffer)) {
+        if (!Objective::evaluate(nbJobs+1,solBuffer,wctBuffer)) {
             return false;
         }
         /// if solBuffer is better than or current min sol, we update minSol
@@ -169,6 +193,7 @@ bool constructSolMinWCT(int nbJobs, int newJob, vector<int> & minSol)
  */
 bool simplifiedRZ(vector<int> & sol, int & wct)
 {
+    ScopedPhase phase("simplifiedRZ");
     if (sol.size() != instance.getNbJob()+1) {
         generateError("localSearch.h","simplifiedRZ","The given sol doesn't have the right size","sol.size()",sol.size());
         return false;
@@ -198,7 +223,11 @@ bool simplifiedRZ(vector<int> & sol, int & wct)
         if (!instance.getPriority(job,priorityBuffer)) {
             return false;
         }
-        ratios[job] = ratios[job] / priorityBuffer;
+        if (Objective::type == Makespan) { /// NEH order : non increasing total processing time
+            ratios[job] = -ratios[job];
+        } else {
+            ratios[job] = ratios[job] / priorityBuffer;
+        }
     }
 
     sort(it,permRatios.end(),[&](const int& a, const int& b){return (ratios[a] < ratios[b]);});
@@ -214,7 +243,7 @@ bool simplifiedRZ(vector<int> & sol, int & wct)
     /// updating the solution (global variable)
     //replaceSolByNewSol(solution,sol);
     /// update global WCT
-    if (!instance.computeWCT(instance.getNbJob(),sol,wct)) {
+    if (!Objective::evaluate(instance.getNbJob(),sol,wct)) {
         return false;
     }
 
@@ -247,6 +276,8 @@ bool generateInitialSolution()
  * IMPORTANT PRECONDITIONS : solution = currentSol = bestSol (values wise), WCT = currentWCT = bestWCT
  * We make sure that this is also the case at the end of the function
  * 
+ * The scan stops as soon as stopRequested() (see budget.h), keeping the best solution met so far
+ * 
  * @param[in,out] currentSol Solution before the transpose, will be modified by the transpose selected. For best_improvement, is used as buffer solution (operating transpose, computing WCT on it, update bestSol, then undoing the transpose)
  * @param[in,out] currentWCT WCT associated with currentSol, will change as currentSol evolve
  * @param[in,out] bestSol For first_improvement, is used as a buffer solution. For best_improvement, stores best solution
@@ -256,15 +287,17 @@ bool generateInitialSolution()
  */
 bool transpose(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol, int & bestWCT, bool & improving)
 {
+    ScopedPhase phase("transpose");
     if (pivoting_rule == First_improvement) {
         //printVect(solution);
-        for (int i = 1; i < instance.getNbJob(); i++) {
+        for (int i = 1; i < instance.getNbJob() && !stopRequested(); i++) {
             bestSol[i] = solution[i+1];
             bestSol[i+1] = solution[i];
             //cout << "modif done" << endl;
-            if (!instance.computeWCT(instance.getNbJob(),bestSol,bestWCT)) { /// compute new wct of the transposed solution
+            if (!Objective::evaluate(instance.getNbJob(),bestSol,bestWCT)) { /// compute new wct of the transposed solution
                 return false;
             }
+            STAT_INC(movesEvaluated[Transpose]);
             //cout << "compute WCT done" << endl;
             if (bestWCT < WCT) { /// if the new wct is better than the old one, we end the computation
                 improving = true;
@@ -281,12 +314,13 @@ bool transpose(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol
             }
         }
     } else { /// in best_improvement, bestSol isn't equal to solution and currentSol because it has to remember current best transposition
-        for (int i = 1; i < instance.getNbJob(); i++) {
+        for (int i = 1; i < instance.getNbJob() && !stopRequested(); i++) {
             currentSol[i] = solution[i+1];
             currentSol[i+1] = solution[i];
-            if (!instance.computeWCT(instance.getNbJob(),currentSol,currentWCT)) { /// compute new wct of the transposed solution
+            if (!Objective::evaluate(instance.getNbJob(),currentSol,currentWCT)) { /// compute new wct of the transposed solution
                 return false;
             }
+            STAT_INC(movesEvaluated[Transpose]);
             if (currentWCT < bestWCT) { /// if the new wct is better than the current best one, we update best one
                 if (!replaceSolByNewSol(bestSol,currentSol)) { return false; }
                 bestWCT = currentWCT;
@@ -323,14 +357,16 @@ bool transpose(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol
  */
 bool exchange(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol, int & bestWCT, bool & improving)
 {
+    ScopedPhase phase("exchange");
     if (pivoting_rule == First_improvement) {
-        for (int i = 1; i < instance.getNbJob(); i++) {
-            for (int j = i+1; j <= instance.getNbJob(); j++) {
+        for (int i = 1; i < instance.getNbJob() && !stopRequested(); i++) {
+            for (int j = i+1; j <= instance.getNbJob() && !stopRequested(); j++) {
                 bestSol[i] = solution[j];
                 bestSol[j] = solution[i];
-                if (!instance.computeWCT(instance.getNbJob(),bestSol,bestWCT)) {
+                if (!Objective::evaluate(instance.getNbJob(),bestSol,bestWCT)) {
                     return false;
                 }
+                STAT_INC(movesEvaluated[Exchange]);
                 if (bestWCT < WCT) {
                     improving = true;
                     if (!replaceSolByNewSol(solution,bestSol)) { return false; }
@@ -347,13 +383,14 @@ bool exchange(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol,
             }
         }
     } else {
-        for (int i = 1; i < instance.getNbJob(); i++) {
-            for (int j = i+1; j <= instance.getNbJob(); j++) {
+        for (int i = 1; i < instance.getNbJob() && !stopRequested(); i++) {
+            for (int j = i+1; j <= instance.getNbJob() && !stopRequested(); j++) {
                 currentSol[i] = solution[j];
                 currentSol[j] = solution[i];
-                if (!instance.computeWCT(instance.getNbJob(),currentSol,currentWCT)) {
+                if (!Objective::evaluate(instance.getNbJob(),currentSol,currentWCT)) {
                     return false;
                 }
+                STAT_INC(movesEvaluated[Exchange]);
                 if (currentWCT < bestWCT) {
                     if (!replaceSolByNewSol(bestSol,currentSol)) { return false; }
                     bestWCT = currentWCT;
@@ -406,6 +443,61 @@ bool operateInsert(int & i, int & j, vector<int> oldSolution, vector<int> & newS
     return true;
 }
 
+/**
+ * Operate a insert neighborhood using the accelerated best insertion of the objective (see objective.h)
+ * 
+ * For each job, all its insertion positions are evaluated at once : the job is removed from the solution
+ * and reinserted at its best position. Same parameters and preconditions as insert.
+ * 
+ * @return false if one error occured, true otherwise
+ */
+bool insertAccelerated(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol, int & bestWCT, bool & improving)
+{
+    ScopedPhase phase("insert");
+    int nbJobs = instance.getNbJob();
+    int position;
+    int value;
+    vector<int> partialSol (nbJobs+1);
+
+    for (int i = 1; i <= nbJobs && !stopRequested(); i++) {
+        /// partialSol is the solution without the job at position i
+        for (int x = 1; x < i; x++) {
+            partialSol[x] = solution[x];
+        }
+        for (int x = i; x < nbJobs; x++) {
+            partialSol[x] = solution[x+1];
+        }
+        if (!Objective::bestInsertion(nbJobs-1,partialSol,solution[i],position,value)) {
+            return false;
+        }
+        STAT_ADD(movesEvaluated[Insert],nbJobs-1);
+        /// in first_improvement bestWCT = WCT, in best_improvement bestWCT is the best value of the scan
+        if (value < bestWCT) {
+            for (int x = 1; x < position; x++) {
+                bestSol[x] = partialSol[x];
+            }
+            bestSol[position] = solution[i];
+            for (int x = position+1; x <= nbJobs; x++) {
+                bestSol[x] = partialSol[x-1];
+            }
+            bestWCT = value;
+            if (pivoting_rule == First_improvement) {
+                break;
+            }
+        }
+    }
+    if (bestWCT < WCT) {
+        improving = true;
+        if (!replaceSolByNewSol(solution,bestSol)) { return false; }
+        if (!replaceSolByNewSol(currentSol,bestSol)) { return false; }
+        WCT = bestWCT;
+        currentWCT = bestWCT;
+        return true;
+    }
+    improving = false;
+    return true;
+}
+
 /**
  * Operate a insert neighborhood on the given current solution, according to the pivoting parameter (pivoting_rule)
  * 
@@ -418,9 +510,13 @@ bool operateInsert(int & i, int & j, vector<int> oldSolution, vector<int> & newS
  */
 bool insert(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol, int & bestWCT, bool & improving)
 {
+    if (Objective::hasAcceleratedInsertion) {
+        return insertAccelerated(currentSol,currentWCT,bestSol,bestWCT,improving);
+    }
+    ScopedPhase phase("insert");
     if (pivoting_rule == First_improvement) {
-        for (int i = 1; i <= instance.getNbJob(); i++) {
-            for (int j = 1; j <= instance.getNbJob(); j++) {
+        for (int i = 1; i <= instance.getNbJob() && !stopRequested(); i++) {
+            for (int j = 1; j <= instance.getNbJob() && !stopRequested(); j++) {
                 if (i != j) {
                     if (i < j) {
                         for (int x = i; x < j; x++) {
@@ -433,9 +529,10 @@ bool insert(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol, i
                         }
                         bestSol[j] = solution[i];
                     }
-                    if (!instance.computeWCT(instance.getNbJob(),bestSol,bestWCT)) {
+                    if (!Objective::evaluate(instance.getNbJob(),bestSol,bestWCT)) {
                         return false;
                     }
+                    STAT_INC(movesEvaluated[Insert]);
                     if (bestWCT < WCT) {
                         improving = true;
                         if (!replaceSolByNewSol(solution,bestSol)) { return false; }
@@ -461,8 +558,8 @@ bool insert(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol, i
             }
         }
     } else {
-        for (int i = 1; i <= instance.getNbJob(); i++) {
-            for (int j = 1; j <= instance.getNbJob(); j++) {
+        for (int i = 1; i <= instance.getNbJob() && !stopRequested(); i++) {
+            for (int j = 1; j <= instance.getNbJob() && !stopRequested(); j++) {
                 if (i != j) {
                     if (i < j) {
                         for (int x = i; x < j; x++) {
@@ -475,9 +572,10 @@ bool insert(vector<int> & currentSol, int & currentWCT, vector<int> & bestSol, i
                         }
                         currentSol[j] = solution[i];
                     }
-                    if (!instance.computeWCT(instance.getNbJob(),currentSol,currentWCT)) {
+                    if (!Objective::evaluate(instance.getNbJob(),currentSol,currentWCT)) {
                         return false;
                     }
+                    STAT_INC(movesEvaluated[Insert]);
                     if (currentWCT < bestWCT) {
                         if (!replaceSolByNewSol(bestSol,currentSol)) { return false; }
                         bestWCT = currentWCT;
@@ -630,6 +728,8 @@ bool vnd(bool generateInitial, bool verbose)
 
     bool improving = false;
 
+    STAT_INC(vndDescents);
+
     while (i <= k) {
         improving = false;
         if (!setPivotingRule(i)) {
@@ -651,6 +751,7 @@ bool vnd(bool generateInitial, bool verbose)
         if (!improving) {
             i ++;
         } else {
+            STAT_INC(movesAccepted[neighborhood]);
             i = 1;
         }
     }
@@ -670,6 +771,8 @@ bool vnd(bool generateInitial, bool verbose)
  * @return false if an error occured, true otherwise
  */
 bool embeddedVND(vector<int> & sol, int & wct) {
+    ScopedPhase phase("embeddedVND");
+    ScopedLatency latency(vndLatency);
     if (sol.size() != instance.getNbJob()+1) {
         generateError("localSearch.h","embeddedVND","sol doesn't have the right size","sol.size()",sol.size());
         return false;
@@ -0,0 +1,262 @@
+/*****************************************************************************
+ * Lower bounds on the objective (see objective.h) and optimality gap        *
+ *****************************************************************************/
+
+#ifndef _LOWERBOUND_H_
+#define _LOWERBOUND_H_
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <climits>
+#include <cstdlib>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "objective.h"
+
+using namespace std;
+
+/**
+ * Compute the single machine relaxation lower bound of the given machine
+ * 
+ * The machine is the only capacity constraint kept : no job can start on it before the smallest head
+ * (sum of its processing times on the previous machines), and each job still has to be processed on the
+ * next machines after it (tail). On one machine, the weighted sum of completion times is minimized by
+ * Smith's rule (WSPT), so the bound is
+ *      sum_j w_j * (minHead + C_j^WSPT + tail_j)
+ * 
+ * @param[in] source The instance (the global instance is thread_local, the caller passes its own)
+ * @param[in] machine The machine kept in the relaxation
+ * @param[out] lb The resulting lower bound
+ * @return false if one error occured, true otherwise
+ */
+bool machineLowerBound(PfspInstance & source, int machine, long long & lb)
+{
+    int nbJobs = source.getNbJob();
+    int timeBuffer;
+    vector<long long> head (nbJobs+1, 0);
+    vector<long long> tail (nbJobs+1, 0);
+    vector<int> p (nbJobs+1);
+    vector<int> w (nbJobs+1);
+    vector<int> order (nbJobs);
+
+    for (int job = 1; job <= nbJobs; job++) {
+        for (int m = 1; m <= source.getNbMac(); m++) {
+            if (!source.getTime(job,m,timeBuffer)) { return false; }
+            if (m < machine) { head[job] += timeBuffer; }
+            else if (m > machine) { tail[job] += timeBuffer; }
+            else { p[job] = timeBuffer; }
+        }
+        if (!source.getPriority(job,w[job])) { return false; }
+        order[job-1] = job;
+    }
+
+    long long minHead = *min_element(head.begin()+1,head.end());
+
+    /// Smith's rule : non decreasing p_j / w_j
+    sort(order.begin(),order.end(),[&](const int & a, const int & b){return ((long long)p[a]*w[b] < (long long)p[b]*w[a]);});
+
+    long long completion = minHead;
+    lb = 0;
+    for (int i = 0; i < nbJobs; i++) {
+        completion += p[order[i]];
+        lb += w[order[i]] * (completion + tail[order[i]]);
+    }
+    return true;
+}
+
+/**
+ * Compute the single machine lower bound of the given machine, for the makespan
+ * 
+ * The machine can't start before the smallest head, processes all the jobs, and the last one still needs
+ * at least the smallest tail : minHead + sum_j p_j + minTail
+ * 
+ * @param[in] source The instance (the global instance is thread_local, the caller passes its own)
+ * @param[in] machine The machine kept in the relaxation
+ * @param[out] lb The resulting lower bound
+ * @return false if one error occured, true otherwise
+ */
+bool machineMakespanLowerBound(PfspInstance & source, int machine, long long & lb)
+{
+    int timeBuffer;
+    long long head;
+    long long tail;
+    long long minHead = -1;
+    long long minTail = -1;
+
+    lb = 0;
+    for (int job = 1; job <= source.getNbJob(); job++) {
+        head = 0;
+        tail = 0;
+        for (int m = 1; m <= source.getNbMac(); m++) {
+            if (!source.getTime(job,m,timeBuffer)) { return false; }
+            if (m < machine) { head += timeBuffer; }
+            else if (m > machine) { tail += timeBuffer; }
+            else { lb += timeBuffer; }
+        }
+        if (minHead < 0 || head < minHead) { minHead = head; }
+        if (minTail < 0 || tail < minTail) { minTail = tail; }
+    }
+    lb += minHead + minTail;
+    return true;
+}
+
+/**
+ * Compute the lower bound of the global instance and store it in the global lowerBound
+ * 
+ * The bound is the maximum over the machines of the single machine relaxations, and of the trivial
+ * bound where each job is processed alone. The machines can be shared among several threads.
+ * For the weighted tardiness (see objective.h), no bound is known and lowerBound is 0.
+ * 
+ * @param[in] nbThreads Number of threads computing the machine bounds
+ * @return false if one error occured, true otherwise
+ */
+bool computeLowerBound(int nbThreads)
+{
+    int nbMachines = instance.getNbMac();
+    int timeBuffer;
+    int priorityBuffer;
+
+    if (nbThreads < 1) {
+        generateError("lowerBound.h","computeLowerBound","nbThreads should have a positive value","nbThreads",nbThreads);
+        return false;
+    }
+
+    if (Objective::type == Weighted_tardiness) {
+        lowerBound = 0;
+        return true;
+    }
+
+    /// trivial bound : each job alone in the shop
+    long long best = 0;
+    long long totalTime;
+    for (int job = 1; job <= instance.getNbJob(); job++) {
+        totalTime = 0;
+        for (int m = 1; m <= nbMachines; m++) {
+            if (!instance.getTime(job,m,timeBuffer)) { return false; }
+            totalTime += timeBuffer;
+        }
+        if (!instance.getPriority(job,priorityBuffer)) { return false; }
+        if (Objective::type == Makespan) {
+            best = max(best,totalTime);
+        } else {
+            best += priorityBuffer * totalTime;
+        }
+    }
+
+    /// single machine relaxations, machine m is handled by the thread (m-1) % nbThreads
+    vector<long long> machineLB (nbMachines+1, 0);
+    vector<char> machineOK (nbMachines+1, true);
+    PfspInstance & source = instance;
+    auto worker = [&](int first) {
+        for (int m = first; m <= nbMachines; m += nbThreads) {
+            if (Objective::type == Makespan) {
+                machineOK[m] = machineMakespanLowerBound(source,m,machineLB[m]);
+            } else {
+                machineOK[m] = machineLowerBound(source,m,machineLB[m]);
+            }
+        }
+    };
+
+    if (nbThreads == 1) {
+        worker(1);
+    } else {
+        vector<thread> threads;
+        for (int t = 1; t <= nbThreads && t <= nbMachines; t++) {
+            threads.push_back(thread(worker,t));
+        }
+        for (thread & th : threads) {
+            th.join();
+        }
+    }
+
+    for (int m = 1; m <= nbMachines; m++) {
+        if (!machineOK[m]) { return false; }
+        best = max(best,machineLB[m]);
+    }
+
+    lowerBound = best;
+    return true;
+}
+
+/**
+ * Check that the objective of every solution of the instance fits in an int, the type the objectives are computed in :
+ * beyond, a solution would be silently mis-scored. The worst case is the total processing time (makespan), times the
+ * sum of the priorities for the weighted objectives.
+ *
+ * @param[in] name Name of the instance, for the error message
+ * @return false if the objective may exceed INT_MAX, true otherwise
+ */
+bool checkObjectiveRange(string name)
+{
+    double totalTime = 0.;
+    double totalPriority = 0.;
+    int value;
+    for (int j = 1; j <= instance.getNbJob(); j++) {
+        for (int m = 1; m <= instance.getNbMac(); m++) {
+            instance.getTime(j,m,value);
+            totalTime += value;
+        }
+        instance.getPriority(j,value);
+        totalPriority += abs(value);
+    }
+    double worstCase = Objective::type == Makespan ? totalTime : totalTime * totalPriority;
+    if (worstCase > INT_MAX) {
+        generateError("lowerBound.h","checkObjectiveRange","the objective of " + name + " may exceed the int range, use fewer jobs, "
+                      "shorter times or smaller priorities","worst case",worstCase);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Relative gap between the given WCT and the lower bound of the instance
+ * 
+ * @param[in] wct The WCT of a solution
+ * @return the gap in percent, 100*(wct - lowerBound)/lowerBound, 0 if wct is the lower bound,
+ *         negative if there is no usable bound (lowerBound 0, e.g. weighted tardiness)
+ */
+double optimalityGap(int wct)
+{
+    if (wct == lowerBound) {
+        return 0.;
+    }
+    if (lowerBound <= 0) {
+        return -1.;
+    }
+    return 100.*(wct - lowerBound)/(double)lowerBound;
+}
+
+/**
+ * Optimality gap for the console output
+ *
+ * @param[in] wct The WCT of a solution
+ * @return the gap in percent followed by %, or n/a if there is no usable bound
+ */
+string formatGap(int wct)
+{
+    double gap = optimalityGap(wct);
+    if (gap < 0) {
+        return "n/a";
+    }
+    ostringstream text;
+    text << gap << "%";
+    return text.str();
+}
+
+/**
+ * Test if the given WCT is proven to be within the requested gap (target_gap) of the optimum
+ * 
+ * @param[in] wct The WCT of the incumbent solution
+ * @return true if the heuristic can stop, false otherwise (or if no gap was requested)
+ */
+bool gapReached(int wct)
+{
+    double gap = optimalityGap(wct);
+    return target_gap >= 0 && gap >= 0 && gap <= target_gap;
+}
+
+#endif
@@ -1,29 +1,119 @@
 
+#include <csignal>
+
 #include "localSearch.h"
 #include "experiment.h"
 #include "aco.h"
 #include "ils.h"
+#include "ig.h"
+#include "regression.h"
+#include "generator.h"
+#include "scaling.h"
+#include "serve.h"
+
+/**
+ * SIGINT/SIGTERM handler : the running heuristic stops at its next check and keeps its best solution
+ */
+void handleStopSignal(int) {
+    requestCancellation();
+}
 
 int main(int argc, char * argv[]) {
 
+    if (argc == 4 && strcmp(argv[1], "--convert") == 0) {
+        return convertInstance(argv[2],argv[3]) ? 0 : 1;
+    }
+    if (argc >= 4 && strcmp(argv[1], "--merge") == 0) {
+        return mergeJournals(argv[2],vector<string>(argv + 3, argv + argc)) ? 0 : 1;
+    }
+    if (argc >= 3 && strcmp(argv[1], "--generate") == 0) {
+        return runGenerator(argc,argv);
+    }
+    if (argc >= 3 && strcmp(argv[1], "--regression") == 0) {
+        argc_global = argc;
+        argv_global.assign(argv, argv + argc);
+        return runRegression();
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "--serve") == 0) {
+        argc_global = argc;
+        argv_global.assign(argv, argv + argc);
+        signal(SIGINT,handleStopSignal);
+        signal(SIGTERM,handleStopSignal);
+        return runServe() ? 0 : 1;
+    }
+
     if (!readSLS(argc,argv)) {
         help();
-        return false;
+        return 1;
+    }
+
+    signal(SIGINT,handleStopSignal);
+    signal(SIGTERM,handleStopSignal);
+
+    if (find(argv_global.begin(), argv_global.end(), "--batch") != argv_global.end()) {
+        return runBatch() ? 0 : 1;
+    }
+
+    string pattern;
+    string manifestName;
+    int nbRuns;
+    double timeLimit = 250*1000.;
+
+    if (!readExperimentArguments(pattern,manifestName,nbRuns,timeLimit)) {
+        return 1;
+    }
+    if (experiment) {
+        return runExperimentTwo(pattern,manifestName,nbRuns,timeLimit) ? 0 : 1;
+    }
+    if (scaling) {
+        int maxThreads = experiment_threads > 1 ? experiment_threads : max(1,(int)thread::hardware_concurrency());
+        return runScaling(pattern,maxThreads,nbRuns,timeLimit) ? 0 : 1;
     }
 
     bool readParams = true;
     int target = 0;
-    double timeLimit = 250*1000.;
 
     if (sls_global == ACO) {
         if (!ACO_heuristic(readParams,target,timeLimit)) {
-            return false;
+            return 1;
         }
-    } else {
+    } else if (sls_global == ILS) {
         if (!ILS_heuristic(readParams,target,timeLimit)) {
-            return false;
+            return 1;
+        }
+    } else {
+        if (!IG_heuristic(readParams,target,timeLimit)) {
+            return 1;
+        }
+    }
+
+    if (!store_directory.empty()) {
+        bool improved;
+        if (!storeUpdate(lastRun.bestSol,lastRun.bestWCT,improved)) {
+            return 1;
+        }
+        if (improved && !quiet) {
+            cout << "new best known solution stored in " << storeFileName() << endl;
+        }
+    }
+    if (!results_file.empty()) {
+        if (!startResultsWriter(results_file)) {
+            return 1;
+        }
+        pushResult(instance_file,lastRun);
+        stopResultsWriter();
+    }
+    if (!trace_file.empty()) {
+        if (!writeTrace(trace_file,instance_file)) {
+            return 1;
+        }
+    }
+    if (!phase_trace_file.empty()) {
+        if (!exportPhaseTrace(phase_trace_file)) {
+            return 1;
         }
     }
 
-    return true;
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*********************************************************************
+ * Objective functions, chosen at compile time (make OBJECTIVE=...)  *
+ *********************************************************************/
+
+#ifndef _OBJECTIVE_H_
+#define _OBJECTIVE_H_
+
+#include <vector>
+
+#include "globalVariables.h"
+#include "stats.h"
+
+using namespace std;
+
+enum Objective_type { Weighted_completion_time, Makespan, Weighted_tardiness };
+
+/**
+ * Each policy gives the evaluator of its objective and, when the objective has one, an accelerated
+ * best insertion. The heuristics only call Objective::..., a typedef resolved at compile time, so
+ * there is no dispatch in the inner loops.
+ * 
+ *  - evaluate(nbJobs, sol, value) : value of the partial solution sol[1:nbJobs]
+ *  - bestInsertion(nbJobs, sol, newJob, bestPosition, bestValue) : only used if hasAcceleratedInsertion
+ */
+
+/// Weighted sum of completion times, the objective of the project
+struct WCTPolicy {
+    static const Objective_type type = Weighted_completion_time;
+    static const bool hasAcceleratedInsertion = false;
+
+    static const char * name() { return "weighted completion time"; }
+    static const char * shortName() { return "wct"; }
+
+    static bool evaluate(int nbJobs, vector<int> & sol, int & value) {
+        countEvaluation(nbJobs);
+        return instance.computeWCT(nbJobs,sol,value);
+    }
+    static bool bestInsertion(int, vector<int> &, int, int &, int &) {
+        return false;
+    }
+};
+
+/// Makespan, with Taillard's O(n.m) evaluation of all the insertion positions
+struct MakespanPolicy {
+    static const Objective_type type = Makespan;
+    static const bool hasAcceleratedInsertion = true;
+
+    static const char * name() { return "makespan"; }
+    static const char * shortName() { return "makespan"; }
+
+    static bool evaluate(int nbJobs, vector<int> & sol, int & value) {
+        countEvaluation(nbJobs);
+        return instance.computeMakespan(nbJobs,sol,value);
+    }
+    static bool bestInsertion(int nbJobs, vector<int> & sol, int newJob, int & bestPosition, int & bestValue) {
+        STAT_INC(insertionScans);
+        return instance.bestInsertionMakespan(nbJobs,sol,newJob,bestPosition,bestValue);
+    }
+};
+
+/// Total weighted tardiness, using the due dates of the instance file
+struct WTPolicy {
+    static const Objective_type type = Weighted_tardiness;
+    static const bool hasAcceleratedInsertion = false;
+
+    static const char * name() { return "weighted tardiness"; }
+    static const char * shortName() { return "wt"; }
+
+    static bool evaluate(int nbJobs, vector<int> & sol, int & value) {
+        countEvaluation(nbJobs);
+        return instance.computeWT(nbJobs,sol,value);
+    }
+    static bool bestInsertion(int, vector<int> &, int, int &, int &) {
+        return false;
+    }
+};
+
+#if defined(OBJECTIVE_MAKESPAN)
+typedef MakespanPolicy Objective;
+#elif defined(OBJECTIVE_WT)
+typedef WTPolicy Objective;
+#else
+typedef WCTPolicy Objective;
+#endif
+
+#endif
@@ -7,11 +7,16 @@
 #define _PARAMETERS_H_
 
 #include <iostream>
+#include <sstream>
+#include <cmath>
 #include <string.h>
 
 #include "globalVariables.h"
 #include "pfspinstance.h"
 #include "errors.h"
+#include "files.h"
+#include "random.h"
+#include "campaign.h"
 
 /**
  * Print global parameters values
@@ -70,22 +75,68 @@ void setDefaultParameters()
 }
 
 /**
- * Initialize ACO parameters with default values
+ * Initialize ACO parameters with default values, or the ones of the request being solved (parameterOverrides)
  */
 void setDefaultParameters(double & rho, int & max_iterations)
 {
 	rho = 0.75;
     max_iterations = 50;
+    if (parameterOverrides.rho >= 0) { rho = parameterOverrides.rho; }
+    if (parameterOverrides.max_iterations >= 0) { max_iterations = parameterOverrides.max_iterations; }
 }
 
 /**
- * Initialize ILS parameters with default values
+ * Initialize ILS parameters with default values, or the ones of the request being solved (parameterOverrides)
  */
 void setDefaultParameters(int & nbPerturbationSteps, int & max_iterations, double & lambda)
 {
 	nbPerturbationSteps = 2;
     max_iterations = 50;
     lambda = 4.;
+    if (parameterOverrides.nbPerturbationSteps >= 0) { nbPerturbationSteps = parameterOverrides.nbPerturbationSteps; }
+    if (parameterOverrides.max_iterations >= 0) { max_iterations = parameterOverrides.max_iterations; }
+    if (parameterOverrides.lambda >= 0) { lambda = parameterOverrides.lambda; }
+}
+
+/**
+ * Initialize IG parameters with default values, or the ones of the request being solved (parameterOverrides)
+ */
+void setDefaultIGParameters(int & nbDestructions, int & max_iterations, double & lambda)
+{
+	nbDestructions = 4;
+    max_iterations = 50;
+    lambda = 0.4;
+    if (parameterOverrides.nbDestructions >= 0) { nbDestructions = parameterOverrides.nbDestructions; }
+    if (parameterOverrides.max_iterations >= 0) { max_iterations = parameterOverrides.max_iterations; }
+    if (parameterOverrides.lambda >= 0) { lambda = parameterOverrides.lambda; }
+}
+
+/**
+ * Check the value of a parameter of the heuristics, given on the command line of the IG or by a request of the solver daemon (see serve.h)
+ * 
+ * @param[in] name rho, max_iterations, nbPerturbationSteps, lambda or nbDestructions
+ * @param[in] value Its value
+ * @param[out] message Why the value is out of range
+ * @return false if the value is out of range, true otherwise
+ */
+bool checkParameter(string name, double value, string & message)
+{
+    bool valid = true;
+    if (name == "rho") {
+        valid = value >= 0 && value <= 1;
+    } else if (name == "max_iterations" || name == "nbDestructions") {
+        valid = value >= 1 && value == floor(value);
+    } else if (name == "nbPerturbationSteps") {
+        valid = value >= 0 && value == floor(value);
+    } else if (name == "lambda") {
+        valid = value >= 0;
+    }
+    if (!valid) {
+        ostringstream text;
+        text << name << " out of range : " << value;
+        message = text.str();
+    }
+    return valid;
 }
 
 /**
@@ -108,6 +159,9 @@ bool readSLS(int argc, char *argv[])
         else if (strcmp(argv[2], "ILS") == 0) {
             sls_global = ILS;
         }
+        else if (strcmp(argv[2], "IG") == 0) {
+            sls_global = IG;
+        }
         else {
             generateError("parameters.h","readArguments","SLS parameter not recognized","sls",argv[2]);
             return false;
@@ -127,6 +181,82 @@ bool readSLS(int argc, char *argv[])
 	return true;
 }
 
+/**
+ * Read one of the arguments shared by all the SLS : instance, budget, gap, cache, seed and outputs
+ * 
+ * @param[in,out] i Index of the argument in argv_global, moved to its value if it has one
+ * @return true if the argument was recognised, false otherwise
+ */
+bool readCommonArgument(int & i)
+{
+    if (argv_global[i] == "--instance_file") {
+        instance_file = new char [argv_global[i+1].size()+1];
+        strcpy(instance_file,argv_global[i+1].c_str());
+        i++;
+    } else if (argv_global[i] == "--max_evaluations") {
+        max_evaluations = stod(argv_global[i+1]);
+        i++;
+    } else if (argv_global[i] == "--gap") {
+        target_gap = stod(argv_global[i+1]);
+        i++;
+    } else if (argv_global[i] == "--lb_threads") {
+        lb_threads = stoi(argv_global[i+1]);
+        i++;
+    } else if (argv_global[i] == "--no_cache") {
+        use_instance_cache = false;
+    } else if (argv_global[i] == "--seed") {
+        seed = stoul(argv_global[i+1]);
+        i++;
+    } else if (argv_global[i] == "--results") {
+        results_file = argv_global[i+1];
+        i++;
+    } else if (argv_global[i] == "--trace") {
+        trace_file = argv_global[i+1];
+        i++;
+    } else if (argv_global[i] == "--quiet") {
+        quiet = true;
+    } else if (argv_global[i] == "--latency") {
+        latency_report = true;
+    } else if (argv_global[i] == "--cpu_time") {
+        cpu_time = true;
+    } else if (argv_global[i] == "--initial_solution") {
+        initial_solution_file = argv_global[i+1];
+        i++;
+    } else if (argv_global[i] == "--edits") {
+        edits_file = argv_global[i+1];
+        i++;
+    } else if (argv_global[i] == "--store") {
+        store_directory = argv_global[i+1];
+        i++;
+    } else if (argv_global[i] == "--store_elite") {
+        store_elite = stoi(argv_global[i+1]);
+        if (store_elite < 1) {
+            generateError("parameters.h","readCommonArgument","store_elite should be positive","store_elite",store_elite);
+            return false;
+        }
+        i++;
+    } else if (argv_global[i] == "--checkpoint") {
+        checkpoint_file = argv_global[i+1];
+        i++;
+    } else if (argv_global[i] == "--checkpoint_period") {
+        checkpoint_period = stod(argv_global[i+1]);
+        i++;
+    } else if (argv_global[i] == "--phase_trace") {
+        phase_trace_file = argv_global[i+1];
+        i++;
+    } else if (argv_global[i] == "--stats") {
+        stats_format = argv_global[i+1];
+        if (stats_format != "text" && stats_format != "json") {
+            generateError("parameters.h","readCommonArgument","stats format should be text or json","stats",stats_format);
+            return false;
+        }
+        i++;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 bool readACOArguments(double & rho, int & max_iterations) {
 
 	setDefaultParameters(rho,max_iterations);
@@ -138,23 +268,20 @@ bool readACOArguments(double & rho, int & max_iterations) {
 		} else if(argv_global[i] == "--max_iterations") {
 			max_iterations = stoi(argv_global[i+1]);
 			i++;
-        } else if(argv_global[i] == "--instance_file") {
-            instance_file = new char [argv_global[i+1].size()];
-            strcpy(instance_file,argv_global[i+1].c_str());
-            cout << endl;
-            i++;
-		} else {
+		} else if (!readCommonArgument(i)) {
             generateError("parameters.h","readACOArguments","Parameter not recognised","Parameter",argv_global[i]);
             help();
 			return false;
 		}
 	}
 
+    seedRandom(seed);
+
     if (instance_file == NULL) {
         generateError("parameters.h","readACOArguments","Instance has to be specified");
         return false;
     } else {
-        if (!instance.readDataFromFile(instance_file)) {
+        if (!loadInstance(instance_file)) {
             return false;
         }
     }
@@ -176,23 +303,20 @@ bool readILSArguments(int & nbPerturbationSteps, int & max_iterations, double &
         } else if(argv_global[i] == "--lambda"){
             lambda = stod(argv_global[i+1]);
             i++;
-		} else if(argv_global[i] == "--instance_file") {
-            instance_file = new char [argv_global[i+1].size()];
-            strcpy(instance_file,argv_global[i+1].c_str());
-            cout << endl;
-            i++;
-		} else {
+		} else if (!readCommonArgument(i)) {
             generateError("parameters.h","readILSArguments","Parameter not recognised","Parameter",argv_global[i]);
             help();
 			return false;
 		}
 	}
 
+    seedRandom(seed);
+
     if (instance_file == NULL) {
         generateError("parameters.h","readILSArguments","Instance has to be specified");
         return false;
     } else {
-        if (!instance.readDataFromFile(instance_file)) {
+        if (!loadInstance(instance_file)) {
             return false;
         }
     }
@@ -200,4 +324,162 @@ bool readILSArguments(int & nbPerturbationSteps, int & max_iterations, double &
 	return true;
 }
 
-#endif
\ No newline at end of file
+bool readIGArguments(int & nbDestructions, int & max_iterations, double & lambda) {
+
+	setDefaultIGParameters(nbDestructions, max_iterations, lambda);
+
+	for(int i=3; i< argc_global ; i++){
+		if(argv_global[i] == "--nbDestructions"){
+			nbDestructions = stoi(argv_global[i+1]);
+			i++;
+		} else if(argv_global[i] == "--max_iterations"){
+			max_iterations = stoi(argv_global[i+1]);
+			i++;
+        } else if(argv_global[i] == "--lambda"){
+            lambda = stod(argv_global[i+1]);
+            i++;
+		} else if (!readCommonArgument(i)) {
+            generateError("parameters.h","readIGArguments","Parameter not recognised","Parameter",argv_global[i]);
+            help();
+			return false;
+		}
+	}
+
+    if (!checkpoint_file.empty()) {
+        generateError("parameters.h","readIGArguments","the IG is not checkpointed, --checkpoint is only supported by ACO and ILS");
+        return false;
+    }
+    if (!edits_file.empty()) {
+        generateError("parameters.h","readIGArguments","the IG does not follow the edits of the instance, --edits is only supported by ACO and ILS");
+        return false;
+    }
+    string message;
+    if (!checkParameter("nbDestructions",nbDestructions,message) || !checkParameter("max_iterations",max_iterations,message)
+        || !checkParameter("lambda",lambda,message)) {
+        generateError("parameters.h","readIGArguments",message);
+        return false;
+    }
+
+    seedRandom(seed);
+
+    if (instance_file == NULL) {
+        generateError("parameters.h","readIGArguments","Instance has to be specified");
+        return false;
+    } else {
+        if (!loadInstance(instance_file)) {
+            return false;
+        }
+    }
+
+	return true;
+}
+
+/**
+ * Read the experiment arguments, all the other arguments are ignored (the heuristics use their default parameters)
+ * The global experiment is set to true if --experiment is given, the global scaling if --scaling is given instead
+ * (then --runs is the number of runs per thread, 2 by default, and --threads the largest thread count).
+ * 
+ * @param[out] pattern Directory or glob pattern of the instances (--experiment or --scaling)
+ * @param[out] manifestName Manifest of the targets (--manifest), empty for no target
+ * @param[out] nbRuns Number of runs per instance (--runs)
+ * @param[out] timeLimit Time limit of each run in ms (--time_limit), the global max_evaluations bounds them too (--max_evaluations)
+ * The runs are executed on experiment_threads threads (--threads), recorded in journal_file (--journal), and only the ones
+ * of the shard are executed (--shard i/k).
+ * The results of the runs go to the global results_file (--results) and their improvements to trace_file (--trace) if given,
+ * --quiet silences the console.
+ * @return false if one error occured, true otherwise
+ */
+bool readExperimentArguments(string & pattern, string & manifestName, int & nbRuns, double & timeLimit) {
+
+    pattern = "";
+    manifestName = "";
+    nbRuns = 0;
+    timeLimit = 0.;
+
+    for (int i = 3; i < argc_global; i++) {
+        if (argv_global[i] == "--experiment" && i+1 < argc_global) {
+            pattern = argv_global[i+1];
+            i++;
+        } else if (argv_global[i] == "--scaling" && i+1 < argc_global) {
+            pattern = argv_global[i+1];
+            scaling = true;
+            i++;
+        } else if (argv_global[i] == "--scaling_output" && i+1 < argc_global) {
+            scaling_output = argv_global[i+1];
+            i++;
+        } else if (argv_global[i] == "--manifest" && i+1 < argc_global) {
+            manifestName = argv_global[i+1];
+            i++;
+        } else if (argv_global[i] == "--runs" && i+1 < argc_global) {
+            nbRuns = stoi(argv_global[i+1]);
+            i++;
+        } else if (argv_global[i] == "--threads" && i+1 < argc_global) {
+            experiment_threads = stoi(argv_global[i+1]);
+            i++;
+        } else if (argv_global[i] == "--max_evaluations" && i+1 < argc_global) {
+            max_evaluations = stod(argv_global[i+1]);
+            i++;
+        } else if (argv_global[i] == "--journal" && i+1 < argc_global) {
+            journal_file = argv_global[i+1];
+            i++;
+        } else if (argv_global[i] == "--shard" && i+1 < argc_global) {
+            if (!parseShard(argv_global[i+1],shard_index,shard_count)) {
+                return false;
+            }
+            i++;
+        } else if (argv_global[i] == "--time_limit" && i+1 < argc_global) {
+            timeLimit = stod(argv_global[i+1]);
+            i++;
+        } else if (argv_global[i] == "--results" && i+1 < argc_global) {
+            results_file = argv_global[i+1];
+            i++;
+        } else if (argv_global[i] == "--trace" && i+1 < argc_global) {
+            trace_file = argv_global[i+1];
+            i++;
+        } else if (argv_global[i] == "--quiet") {
+            quiet = true;
+        } else if (argv_global[i] == "--latency") {
+            latency_report = true;
+        } else if (argv_global[i] == "--cpu_time") {
+            cpu_time = true;
+        } else if (argv_global[i] == "--phase_trace" && i+1 < argc_global) {
+            phase_trace_file = argv_global[i+1];
+            i++;
+        } else if (argv_global[i] == "--stats" && i+1 < argc_global) {
+            stats_format = argv_global[i+1];
+            i++;
+        }
+    }
+
+    if (pattern.empty()) {
+        timeLimit = 250*1000.;
+        return true;
+    }
+    if (nbRuns == 0) { /// runs per instance, or per thread for the scaling benchmark
+        nbRuns = scaling ? 2 : 25;
+    }
+    if (timeLimit == 0.) { /// the scaling benchmark relies on an evaluation budget by default
+        timeLimit = 250*1000.;
+        if (scaling && max_evaluations <= 0) {
+            max_evaluations = 100000;
+        }
+    }
+    if (nbRuns <= 0) {
+        generateError("parameters.h","readExperimentArguments","runs should have a positive value","runs",nbRuns);
+        return false;
+    }
+    if (shard_count > 1 && journal_file.empty()) {
+        generateError("parameters.h","readExperimentArguments","a shard needs its journal (--journal)");
+        return false;
+    }
+    if (experiment_threads <= 0) {
+        generateError("parameters.h","readExperimentArguments","threads should have a positive value","threads",experiment_threads);
+        return false;
+    }
+    if (!scaling) {
+        experiment = true;
+    }
+    return true;
+}
+
+#endif
@@ -22,6 +22,19 @@
 #include <vector>
 #include <string.h>
 #include <fstream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <cstdio>
+#include <charconv>
+#include <iterator>
+#include <cctype>
 
 #include "pfspinstance.h"
 
@@ -51,7 +64,10 @@ void PfspInstance::printMatrixBis(vector<vector<int>> & matrix)
 /// Constructor
 PfspInstance::PfspInstance()
 {
-	/// Nothing. We fill the object using the function readDataFromFile(char * filename)
+	/// We fill the object using the function readDataFromFile(char * filename)
+	nbJob = 0;
+	nbMac = 0;
+	nbEvaluations = 0.;
 }
 
 /// Destructor
@@ -69,14 +85,14 @@ int PfspInstance::getNbMac()
 	return nbMac;
 }
 
-/// Allow the memory for the processing times matrix : */
+/// Allow the memory for the processing times matrix, and set the size of the instance : */
 void PfspInstance::allowMatrixMemory(int nbJ, int nbM)
 {
-	processingTimesMatrix.resize(nbJ+1);          /// 1st dimension
+	nbJob = nbJ;
+	nbMac = nbM;
 
-	for (int cpt = 0; cpt < nbJ+1; ++cpt) {
-		processingTimesMatrix[cpt].resize(nbM+1); /// 2nd dimension
-	}
+	/// one contiguous block, row by row : the time of job j on machine m is at j*(nbM+1) + m
+	processingTimesMatrix.assign((size_t)(nbJ+1)*(nbM+1), 0);
 
 	dueDates.resize(nbJ+1);
 	priority.resize(nbJ+1);
@@ -94,7 +110,7 @@ bool PfspInstance::getTime(int job, int machine, int & result)
 			<< job << ", machine=" << machine << std::endl;
 			return false;
 		}
-		result = processingTimesMatrix[job][machine];
+		result = processingTimesMatrix[job*(nbMac+1) + machine];
         return true;
 	}
 }
@@ -115,54 +131,395 @@ bool PfspInstance::getPriority(int job, int & result)
     }
 }
 
-/// Read the instance from file
+/// Setters, used to fill an instance built in memory (allowMatrixMemory first) : */
+void PfspInstance::setTime(int job, int machine, int processTime)
+{
+	processingTimesMatrix[job*(nbMac+1) + machine] = processTime;
+}
+
+int PfspInstance::getDueDate(int job)
+{
+	return dueDates[job];
+}
+
+void PfspInstance::setDueDate(int job, int value)
+{
+	dueDates[job] = value;
+}
+
+void PfspInstance::setPriority(int job, int value)
+{
+	priority[job] = value;
+}
+
+/**
+ * Add a job at the end of the instance (see edits.h)
+ * 
+ * @param[in] times Its processing times, times[1:nbMac]
+ * @param[in] dueDate Its due date
+ * @param[in] weight Its priority
+ * @return the number of the new job, nbJob after the addition
+ */
+int PfspInstance::addJob(vector< int > & times, int dueDate, int weight)
+{
+	nbJob ++;
+	processingTimesMatrix.resize((nbJob+1)*(nbMac+1), 0);
+	for (int m = 1; m <= nbMac; ++m) {
+		processingTimesMatrix[nbJob*(nbMac+1) + m] = times[m];
+	}
+	dueDates.push_back(dueDate);
+	priority.push_back(weight);
+	return nbJob;
+}
+
+/**
+ * Remove a job from the instance, the jobs after it are renumbered (job j becomes j-1) (see edits.h)
+ * 
+ * @param[in] job The job, the instance keeps at least one job
+ * @returns false if an error occured, true otherwise
+ */
+bool PfspInstance::removeJob(int job)
+{
+	if (job < 1 || job > nbJob || nbJob == 1) {
+		cout << "ERROR: file:pfspInstance.cpp, method:removeJob, message:Out of bound or last job. job = " << job << endl;
+		return false;
+	}
+	processingTimesMatrix.erase(processingTimesMatrix.begin() + job*(nbMac+1), processingTimesMatrix.begin() + (job+1)*(nbMac+1));
+	dueDates.erase(dueDates.begin() + job);
+	priority.erase(priority.begin() + job);
+	nbJob --;
+	return true;
+}
+
+/**
+ * Cursor over the whole text of an instance, keeping track of the line and column for the error messages
+ */
+struct TextCursor {
+	const char * current;
+	const char * end;
+	const char * lineBegin;
+	int line;
+	string fileName;
+
+	/// skip blanks and line ends
+	void skipBlanks()
+	{
+		while (current < end && (*current == ' ' || *current == '\t' || *current == '\r' || *current == '\n')) {
+			if (*current == '\n') {
+				++line;
+				lineBegin = current + 1;
+			}
+			++current;
+		}
+	}
+
+	void error(string message)
+	{
+		cout << "ERROR: file:pfspInstance.cpp, method:readDataFromFile, message:" << message
+			 << " in " << fileName << " at line " << line << ", column " << (current - lineBegin) + 1 << endl;
+	}
+
+	/// read the next token as an integer, what is the name of the value for the error message
+	bool nextInt(int & value, const char * what)
+	{
+		skipBlanks();
+		if (current >= end) {
+			error(string("unexpected end of file, expecting ") + what);
+			return false;
+		}
+		from_chars_result result = from_chars(current, end, value);
+		if (result.ec == errc::result_out_of_range) {
+			error(string("integer out of range for ") + what);
+			return false;
+		}
+		if (result.ec != errc() || (result.ptr < end && !isspace((unsigned char)*result.ptr))) {
+			error(string("malformed integer for ") + what);
+			return false;
+		}
+		current = result.ptr;
+		return true;
+	}
+
+	/// skip the next token, which has to be a word (not a number)
+	bool skipWord(const char * what)
+	{
+		skipBlanks();
+		if (current >= end) {
+			error(string("unexpected end of file, expecting ") + what);
+			return false;
+		}
+		if (!isalpha((unsigned char)*current)) {
+			error(string("expecting ") + what);
+			return false;
+		}
+		while (current < end && !isspace((unsigned char)*current)) {
+			++current;
+		}
+		return true;
+	}
+};
+
+/**
+ * Read the instance from a text file, or from the standard input if fileName is "-"
+ * 
+ * The whole file is read in one go and tokenized with from_chars. Format :
+ *      nbJob nbMac
+ *      nbJob lines of nbMac pairs (machine, processing time)
+ *      Reldue
+ *      nbJob lines : -1 dueDate -1 priority
+ */
 bool PfspInstance::readDataFromFile(string fileName)
 {
-	bool everythingOK = true;
+	string text;
+
+	if (fileName == "-") {
+		text.assign(istreambuf_iterator<char>(cin), istreambuf_iterator<char>());
+	} else {
+		ifstream fileIn(fileName, ios::binary | ios::ate);
+		if (!fileIn.is_open()) {
+			cout    << "ERROR: file:pfspInstance.cpp, method:readDataFromFile, "
+					<< "error while opening file " << fileName << std::endl;
+			return false;
+		}
+		text.resize(fileIn.tellg());
+		fileIn.seekg(0);
+		fileIn.read(&text[0], text.size());
+	}
+	return readDataFromText(text, fileName);
+}
+
+/**
+ * Read the instance from its text (format of readDataFromFile)
+ * 
+ * The instance is parsed aside and only replaced once the whole text is valid : after an error it is unchanged
+ *
+ * @param[in] text The text of the instance
+ * @param[in] fileName Name of the instance, for the error messages
+ */
+bool PfspInstance::readDataFromText(const string & text, string fileName)
+{
 	int j, m; /// iterators
 	int readValue;
-	string str;
-	ifstream fileIn;
 
-	fileIn.open(fileName);
+	TextCursor cursor;
+	cursor.current = text.data();
+	cursor.end = text.data() + text.size();
+	cursor.lineBegin = cursor.current;
+	cursor.line = 1;
+	cursor.fileName = fileName;
 
-	if ( fileIn.is_open() ) {
-		fileIn >> nbJob;
-		fileIn >> nbMac;
-		allowMatrixMemory(nbJob, nbMac);
-		/// reading the processing times
-		for (j = 1; j <= nbJob; ++j)
-		{
-			for (m = 1; m <= nbMac; ++m)
-			{
-				fileIn >> readValue; /// The number of each machine, not important !
-				fileIn >> readValue; /// Process Time
+	int nbJobRead, nbMacRead;
+	if (!cursor.nextInt(nbJobRead, "the number of jobs") || !cursor.nextInt(nbMacRead, "the number of machines")) {
+		return false;
+	}
+	if (nbJobRead < 1 || nbMacRead < 1) {
+		cursor.error("the numbers of jobs and machines should be positive");
+		return false;
+	}
+	/// each (machine, time) pair takes at least 4 characters : a header larger than the text is refused before allocating
+	if (4. * nbJobRead * nbMacRead > (double)(cursor.end - cursor.current)) {
+		cursor.error("the numbers of jobs and machines do not match the length of the file");
+		return false;
+	}
+	size_t rowSize = (size_t)nbMacRead + 1;
+	vector< int > timesRead ((size_t)(nbJobRead + 1) * rowSize, 0);
+	vector< int > dueDatesRead (nbJobRead + 1);
+	vector< int > priorityRead (nbJobRead + 1);
 
-				processingTimesMatrix[j][m] = readValue;
-			}
-		}
-        fileIn >> str; /// this is not read ("Reldue")
-		/// reading the dueDates and priority for each job
-		for (j = 1; j <= nbJob; ++j)
+	/// reading the processing times
+	for (j = 1; j <= nbJobRead; ++j)
+	{
+		for (m = 1; m <= nbMacRead; ++m)
 		{
-			fileIn >> readValue; /// -1
-			fileIn >> readValue;
-			dueDates[j] = readValue;
-			fileIn >> readValue; /// -1
-			fileIn >> readValue;
-            priority[j] = readValue;
+			if (!cursor.nextInt(readValue, "a machine number")) { return false; } /// The number of each machine, not important !
+			if (!cursor.nextInt(readValue, "a processing time")) { return false; }
+			if (readValue < 0) {
+				cursor.error("negative processing time");
+				return false;
+			}
+			timesRead[j*rowSize + m] = readValue;
 		}
-		fileIn.close();
 	}
-	else {
-		cout    << "ERROR: file:pfspInstance.cpp, method:readDataFromFile, "
-				<< "error while opening file " << fileName << std::endl;
+	if (!cursor.skipWord("Reldue")) { return false; } /// this is not read ("Reldue")
+	/// reading the dueDates and priority for each job
+	for (j = 1; j <= nbJobRead; ++j)
+	{
+		if (!cursor.nextInt(readValue, "-1")) { return false; }
+		if (!cursor.nextInt(dueDatesRead[j], "a due date")) { return false; }
+		if (!cursor.nextInt(readValue, "-1")) { return false; }
+		if (!cursor.nextInt(priorityRead[j], "a priority")) { return false; }
+	}
+
+	nbJob = nbJobRead;
+	nbMac = nbMacRead;
+	processingTimesMatrix.swap(timesRead);
+	dueDates.swap(dueDatesRead);
+	priority.swap(priorityRead);
+	nbEvaluations = 0.;
+	return true;
+}
+
+/**
+ * Binary image of an instance, in the byte order of the machine that wrote it :
+ *      header (128 bytes) | times (int32, (nbJob+1)*(nbMac+1), row by row) | dueDates (int32, nbJob+1) | priority (int32, nbJob+1)
+ * The times block starts at a 64 bytes boundary, the checksum is the 64 bits FNV-1a of everything after the header.
+ * A sidecar cache records the size and the modification time (ns) of its text instance, it is only used while they are the same.
+ */
+#define BINARY_MAGIC "PFSPBIN"
+#define BINARY_VERSION 2
+#define BINARY_HEADER_SIZE 128
+
+struct BinaryHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t nbJob;
+	uint32_t nbMac;
+	uint32_t reserved;
+	uint64_t checksum;
+	uint64_t timesOffset;
+	uint64_t dueDatesOffset;
+	uint64_t priorityOffset;
+	uint64_t fileSize;
+	uint64_t sourceSize; /// text instance of a sidecar cache, 0 for a converted image
+	int64_t sourceSeconds;
+	int64_t sourceNanoseconds;
+};
+
+static_assert(sizeof(BinaryHeader) <= BINARY_HEADER_SIZE, "the binary header must fit before the aligned times block");
+
+static uint64_t fnv1a(const char * data, size_t size)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/// Write the binary image of the instance, the sidecar cache of the text instance source if given
+bool PfspInstance::writeBinaryFile(string fileName, const struct stat * source)
+{
+	BinaryHeader header;
+	size_t timesSize = processingTimesMatrix.size() * sizeof(int32_t);
+	size_t vectorSize = (nbJob + 1) * sizeof(int32_t);
+
+	memset(&header, 0, sizeof(header));
+	strcpy(header.magic, BINARY_MAGIC);
+	header.version = BINARY_VERSION;
+	header.nbJob = nbJob;
+	header.nbMac = nbMac;
+	header.timesOffset = BINARY_HEADER_SIZE;
+	if (source != NULL) {
+		header.sourceSize = source->st_size;
+		header.sourceSeconds = source->st_mtim.tv_sec;
+		header.sourceNanoseconds = source->st_mtim.tv_nsec;
+	}
+	header.dueDatesOffset = header.timesOffset + timesSize;
+	header.priorityOffset = header.dueDatesOffset + vectorSize;
+	header.fileSize = header.priorityOffset + vectorSize;
 
+	string payload;
+	payload.resize(header.fileSize - header.timesOffset);
+	memcpy(&payload[0], processingTimesMatrix.data(), timesSize);
+	memcpy(&payload[timesSize], dueDates.data(), vectorSize);
+	memcpy(&payload[timesSize + vectorSize], priority.data(), vectorSize);
+	header.checksum = fnv1a(payload.data(), payload.size());
+
+	/// written in a temporary file of the process and thread (the workers of the daemon may cache the same instance at once),
+	/// then renamed, so a concurrent reader never sees a partial image
+	ostringstream tmpName;
+	tmpName << fileName << ".tmp." << getpid() << "." << this_thread::get_id();
+	ofstream fileOut(tmpName.str(), ios::binary | ios::trunc);
+	if (!fileOut.is_open()) {
+		cout << "ERROR: file:pfspInstance.cpp, method:writeBinaryFile, error while opening file " << tmpName.str() << endl;
+		return false;
+	}
+	char padding[BINARY_HEADER_SIZE];
+	memset(padding, 0, sizeof(padding));
+	memcpy(padding, &header, sizeof(header));
+	fileOut.write(padding, BINARY_HEADER_SIZE);
+	fileOut.write(payload.data(), payload.size());
+	fileOut.close();
+	if (!fileOut || rename(tmpName.str().c_str(), fileName.c_str()) != 0) {
+		cout << "ERROR: file:pfspInstance.cpp, method:writeBinaryFile, error while writing file " << fileName << endl;
+		unlink(tmpName.str().c_str());
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Read the binary image of an instance : the file is mapped in memory and its blocks copied in one go
+ * With source, the image is the sidecar cache of that text instance : a cache of another version of the text
+ * (size or modification time different) or of an older format is stale, false is returned without error.
+ */
+bool PfspInstance::readBinaryFile(string fileName, const struct stat * source)
+{
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		cout << "ERROR: file:pfspInstance.cpp, method:readBinaryFile, error while opening file " << fileName << endl;
+		return false;
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size < BINARY_HEADER_SIZE) {
+		cout << "ERROR: file:pfspInstance.cpp, method:readBinaryFile, file too short " << fileName << endl;
+		close(fd);
+		return false;
+	}
+	void * mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		cout << "ERROR: file:pfspInstance.cpp, method:readBinaryFile, mmap failed on " << fileName << endl;
+		return false;
+	}
+
+	const char * data = (const char *) mapping;
+	BinaryHeader header;
+	memcpy(&header, data, sizeof(header));
+
+	if (source != NULL && (header.version != BINARY_VERSION || header.sourceSize != (uint64_t)source->st_size
+		|| header.sourceSeconds != (int64_t)source->st_mtim.tv_sec || header.sourceNanoseconds != (int64_t)source->st_mtim.tv_nsec)) {
+		munmap(mapping, fileStat.st_size);
+		return false;
+	}
+
+	bool everythingOK = strncmp(header.magic, BINARY_MAGIC, 8) == 0 && header.version == BINARY_VERSION
+		&& header.fileSize == (uint64_t)fileStat.st_size && header.nbJob > 0 && header.nbMac > 0
+		&& header.timesOffset == BINARY_HEADER_SIZE
+		&& header.dueDatesOffset == header.timesOffset + (uint64_t)(header.nbJob + 1) * (header.nbMac + 1) * sizeof(int32_t)
+		&& header.priorityOffset == header.dueDatesOffset + (header.nbJob + 1) * sizeof(int32_t)
+		&& header.fileSize == header.priorityOffset + (header.nbJob + 1) * sizeof(int32_t);
+	if (!everythingOK) {
+		cout << "ERROR: file:pfspInstance.cpp, method:readBinaryFile, malformed header in " << fileName << endl;
+	} else if (fnv1a(data + header.timesOffset, header.fileSize - header.timesOffset) != header.checksum) {
+		cout << "ERROR: file:pfspInstance.cpp, method:readBinaryFile, wrong checksum in " << fileName << endl;
 		everythingOK = false;
+	} else {
+		nbJob = header.nbJob;
+		nbMac = header.nbMac;
+		allowMatrixMemory(nbJob, nbMac);
+		memcpy(processingTimesMatrix.data(), data + header.timesOffset, header.dueDatesOffset - header.timesOffset);
+		memcpy(dueDates.data(), data + header.dueDatesOffset, (nbJob + 1) * sizeof(int32_t));
+		memcpy(priority.data(), data + header.priorityOffset, (nbJob + 1) * sizeof(int32_t));
+		nbEvaluations = 0.;
 	}
+
+	munmap(mapping, fileStat.st_size);
 	return everythingOK;
 }
 
+/// Test if the given file starts with the magic string of the binary images
+bool PfspInstance::isBinaryFile(string fileName)
+{
+	char magic[8];
+	ifstream fileIn(fileName, ios::binary);
+	if (!fileIn.read(magic, 8)) {
+		return false;
+	}
+	return strncmp(magic, BINARY_MAGIC, 8) == 0;
+}
+
 /**
  * Compute the weighted sum of completion time of a given partial solution
  * 
@@ -185,13 +542,13 @@ bool PfspInstance::computeWCT(int nbJobs, vector< int > & sol, int & wct)
 	for ( j = 1; j <= nbJobs; ++j )
 	{
 		jobNumber = sol[j];
-		previousMachineEndTime[j] = previousMachineEndTime[j-1] + processingTimesMatrix[jobNumber][1];
+		previousMachineEndTime[j] = previousMachineEndTime[j-1] + processingTimesMatrix[jobNumber*(nbMac+1) + 1];
 	}
 
 	/// others machines
 	for ( m = 2; m <= nbMac; ++m )
 	{
-		previousMachineEndTime[1] += processingTimesMatrix[sol[1]][m];
+		previousMachineEndTime[1] += processingTimesMatrix[sol[1]*(nbMac+1) + m];
 		previousJobEndTime = previousMachineEndTime[1];
 
 
@@ -201,12 +558,12 @@ bool PfspInstance::computeWCT(int nbJobs, vector< int > & sol, int & wct)
 
 			if ( previousMachineEndTime[j] > previousJobEndTime )
 			{
-				previousMachineEndTime[j] = previousMachineEndTime[j] + processingTimesMatrix[jobNumber][m];
+				previousMachineEndTime[j] = previousMachineEndTime[j] + processingTimesMatrix[jobNumber*(nbMac+1) + m];
 				previousJobEndTime = previousMachineEndTime[j];
 			}
 			else
 			{
-				previousJobEndTime += processingTimesMatrix[jobNumber][m];
+				previousJobEndTime += processingTimesMatrix[jobNumber*(nbMac+1) + m];
 				previousMachineEndTime[j] = previousJobEndTime;
 			}
 		}
@@ -217,5 +574,161 @@ bool PfspInstance::computeWCT(int nbJobs, vector< int > & sol, int & wct)
 	    wct += previousMachineEndTime[j] * priority[sol[j]];
     }
 
+    /// a full evaluation costs one work unit, a partial one costs nbJobs/nbJob
+    nbEvaluations += (double)nbJobs / nbJob;
+
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * Compute the makespan (completion time of the last job on the last machine) of a given partial solution
+ * 
+ * @param[in] nbJobs Number of jobs currently in solution (sol). IMPORTANT : nbJobs not necessarely equal to the length of sol.
+ * @param[in] sol Solution we want to evaluate
+ * @param[out] makespan Resulting makespan
+ */
+bool PfspInstance::computeMakespan(int nbJobs, vector< int > & sol, int & makespan)
+{
+	int j, m;
+
+	/// completion times of the jobs on the current machine
+	vector< int > machineEndTime ( nbJobs + 1, 0 );
+
+	for ( m = 1; m <= nbMac; ++m )
+	{
+		for ( j = 1; j <= nbJobs; ++j )
+		{
+			machineEndTime[j] = max(machineEndTime[j], machineEndTime[j-1]) + processingTimesMatrix[sol[j]*(nbMac+1) + m];
+		}
+	}
+
+	makespan = machineEndTime[nbJobs];
+
+	nbEvaluations += (double)nbJobs / nbJob;
+
+	return true;
+}
+
+/**
+ * Compute the total weighted tardiness of a given partial solution, using the due dates of the instance
+ * 
+ * @param[in] nbJobs Number of jobs currently in solution (sol). IMPORTANT : nbJobs not necessarely equal to the length of sol.
+ * @param[in] sol Solution we want to evaluate
+ * @param[out] wt Resulting weighted tardiness
+ */
+bool PfspInstance::computeWT(int nbJobs, vector< int > & sol, int & wt)
+{
+	int j, m;
+
+	vector< int > machineEndTime ( nbJobs + 1, 0 );
+
+	for ( m = 1; m <= nbMac; ++m )
+	{
+		for ( j = 1; j <= nbJobs; ++j )
+		{
+			machineEndTime[j] = max(machineEndTime[j], machineEndTime[j-1]) + processingTimesMatrix[sol[j]*(nbMac+1) + m];
+		}
+	}
+
+	wt = 0;
+	for ( j = 1; j <= nbJobs; ++j ) {
+		if (machineEndTime[j] > dueDates[sol[j]]) {
+			wt += (machineEndTime[j] - dueDates[sol[j]]) * priority[sol[j]];
+		}
+	}
+
+	nbEvaluations += (double)nbJobs / nbJob;
+
+	return true;
+}
+
+/**
+ * Find the position where inserting a new job into a partial solution gives the smallest makespan
+ * 
+ * Taillard's acceleration : with the heads e (earliest completion times of the sequence), the tails q
+ * (latest start times counted from the end) and f (completion times of the new job inserted at position p),
+ *      makespan(p) = max_m ( f[p][m] + q[p][m] )
+ * so all the nbJobs+1 positions are evaluated for the cost of about three evaluations.
+ * 
+ * @param[in] nbJobs Number of jobs currently in solution (sol)
+ * @param[in] sol Partial solution, sol[1:nbJobs]
+ * @param[in] newJob The job to insert
+ * @param[out] bestPosition Position, in 1:nbJobs+1, where newJob should be inserted (the first one in case of ties)
+ * @param[out] bestMakespan Makespan of the solution once newJob is inserted at bestPosition
+ */
+bool PfspInstance::bestInsertionMakespan(int nbJobs, vector< int > & sol, int newJob, int & bestPosition, int & bestMakespan)
+{
+	int i, m;
+	int width = nbMac + 2;
+
+	if ((newJob < 1) || (newJob > nbJob)) {
+		cout << "ERROR: file:pfspInstance.cpp, method:bestInsertionMakespan, message:Out of bound. newJob = " << newJob << endl;
+		return false;
+	}
+
+	/// matrices flattened row by row, rows 0:nbJobs+1 and columns 0:nbMac+1 to avoid the border tests
+	vector< int > e ( (nbJobs + 2) * width, 0 );
+	vector< int > q ( (nbJobs + 2) * width, 0 );
+	int fPrevious;
+	int f;
+	int makespan;
+
+	for ( i = 1; i <= nbJobs; ++i ) {
+		for ( m = 1; m <= nbMac; ++m ) {
+			e[i*width + m] = max(e[(i-1)*width + m], e[i*width + m-1]) + processingTimesMatrix[sol[i]*(nbMac+1) + m];
+		}
+	}
+	for ( i = nbJobs; i >= 1; --i ) {
+		for ( m = nbMac; m >= 1; --m ) {
+			q[i*width + m] = max(q[(i+1)*width + m], q[i*width + m+1]) + processingTimesMatrix[sol[i]*(nbMac+1) + m];
+		}
+	}
+
+	bestMakespan = -1;
+	for ( i = 1; i <= nbJobs + 1; ++i ) {
+		fPrevious = 0;
+		makespan = 0;
+		for ( m = 1; m <= nbMac; ++m ) {
+			f = max(fPrevious, e[(i-1)*width + m]) + processingTimesMatrix[newJob*(nbMac+1) + m];
+			makespan = max(makespan, f + q[i*width + m]);
+			fPrevious = f;
+		}
+		if (bestMakespan < 0 || makespan < bestMakespan) {
+			bestMakespan = makespan;
+			bestPosition = i;
+		}
+	}
+
+	nbEvaluations += 3. * (nbJobs + 1) / nbJob;
+
+	return true;
+}
+
+/// Number of work units spent in computeWCT since the last reset
+double PfspInstance::getNbEvaluations()
+{
+	return nbEvaluations;
+}
+
+/// Restart the work units count, called at the beginning of each run
+void PfspInstance::resetNbEvaluations()
+{
+	nbEvaluations = 0.;
+}
+
+/// Set the work units count, when a run is resumed from a checkpoint
+void PfspInstance::setNbEvaluations(double value)
+{
+	nbEvaluations = value;
+}
+
+/// Hash of the content of the instance (sizes, times, due dates, priorities), the same for its text and binary files
+uint64_t PfspInstance::contentHash()
+{
+	int32_t sizes[2] = {nbJob, nbMac};
+	string content ((const char *)sizes, sizeof(sizes));
+	content.append((const char *)processingTimesMatrix.data(), processingTimesMatrix.size() * sizeof(int));
+	content.append((const char *)dueDates.data(), dueDates.size() * sizeof(int));
+	content.append((const char *)priority.data(), priority.size() * sizeof(int));
+	return fnv1a(content.data(), content.size());
+}
@@ -22,6 +22,8 @@
 #define _PFSPINSTANCEWT_H_
 
 #include <vector>
+#include <stdint.h>
+#include <sys/stat.h>
 
 using namespace std;
 
@@ -32,7 +34,8 @@ class PfspInstance{
     int nbMac;
     std::vector< int > dueDates;
     std::vector< int > priority;
-    std::vector< std::vector <int> > processingTimesMatrix;
+    std::vector< int > processingTimesMatrix; /// (nbJob+1) rows of (nbMac+1) times, flattened
+    double nbEvaluations; /// work units spent in computeWCT, a partial evaluation counts fractionally
 
   public:
     void printSolBis(vector<int> & sol);
@@ -45,7 +48,7 @@ class PfspInstance{
     int getNbJob();
     int getNbMac();
 
-    /* Allow the memory for the processing times matrix : */
+    /* Allow the memory for the processing times matrix, and set the size of the instance : */
     void allowMatrixMemory(int nbJ, int nbM);
 
     /**
@@ -65,10 +68,33 @@ class PfspInstance{
     bool getPriority(int job, int & result);
     void setPriority(int job, int value);
 
+    /* Edits in place, the solutions of the instance are repaired afterwards (see edits.h) : */
+    int addJob(vector< int > & times, int dueDate, int weight);
+    bool removeJob(int job);
+
     /* Read Data from a file : */
     bool readDataFromFile(string fileName);
+    bool readDataFromText(const string & text, string fileName);
+
+    /* Binary image of the instance (header, checksum, 64 bytes aligned times block), see pfspinstance.cpp : */
+    bool writeBinaryFile(string fileName, const struct stat * source = NULL);
+    bool readBinaryFile(string fileName, const struct stat * source = NULL);
+    static bool isBinaryFile(string fileName);
 
     bool computeWCT(int nbJobs, vector< int > & sol, int & wct);
+    bool computeMakespan(int nbJobs, vector< int > & sol, int & makespan);
+    bool computeWT(int nbJobs, vector< int > & sol, int & wt);
+
+    /* Taillard's acceleration : makespan of every insertion position in O(nbJobs*nbMac) */
+    bool bestInsertionMakespan(int nbJobs, vector< int > & sol, int newJob, int & bestPosition, int & bestMakespan);
+
+    /* Evaluation budget accounting : */
+    double getNbEvaluations();
+    void resetNbEvaluations();
+    void setNbEvaluations(double value);
+
+    /* 64 bits FNV-1a of the content (sizes, times, due dates, priorities), identifies the instance whatever its file : */
+    uint64_t contentHash();
 };
 
 #endif
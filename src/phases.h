@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * Scoped phase timers, per thread buffers, Chrome trace-event JSON export     *
+ *******************************************************************************/
+
+#ifndef _PHASES_H_
+#define _PHASES_H_
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+
+#include "globalVariables.h"
+#include "errors.h"
+
+using namespace std;
+
+/// events kept per thread, the next ones are only counted
+#define PHASE_BUFFER_CAPACITY (1 << 20)
+
+/// One execution of a phase
+struct PhaseEvent {
+    const char * name;
+    long long begin; /// ns since phaseOrigin
+    long long duration; /// ns
+};
+
+/// Events of one thread : only this thread writes in it, the export reads it once the threads are done
+struct PhaseBuffer {
+    vector<PhaseEvent> events;
+    long long dropped;
+    int tid;
+    PhaseBuffer * next; /// link of the list of all the buffers
+};
+
+atomic<PhaseBuffer *> phaseBuffers (NULL); /// lock-free list of the buffers of all the threads
+atomic<int> nbPhaseThreads (0);
+thread_local PhaseBuffer * localPhaseBuffer = NULL;
+chrono::steady_clock::time_point phaseOrigin = chrono::steady_clock::now();
+
+/**
+ * Record one execution of a phase in the buffer of the calling thread, created and registered on first use
+ * 
+ * @param[in] name Name of the phase, a string literal
+ * @param[in] begin Start of the phase
+ * @param[in] end End of the phase
+ */
+void recordPhase(const char * name, chrono::steady_clock::time_point begin, chrono::steady_clock::time_point end)
+{
+    if (localPhaseBuffer == NULL) {
+        localPhaseBuffer = new PhaseBuffer;
+        localPhaseBuffer->events.reserve(4096);
+        localPhaseBuffer->dropped = 0;
+        localPhaseBuffer->tid = ++nbPhaseThreads;
+        localPhaseBuffer->next = phaseBuffers.load(memory_order_relaxed);
+        while (!phaseBuffers.compare_exchange_weak(localPhaseBuffer->next, localPhaseBuffer, memory_order_release, memory_order_relaxed)) {
+        }
+    }
+    if (localPhaseBuffer->events.size() >= PHASE_BUFFER_CAPACITY) {
+        localPhaseBuffer->dropped ++;
+        return;
+    }
+    PhaseEvent event;
+    event.name = name;
+    event.begin = chrono::duration_cast<chrono::nanoseconds>(begin - phaseOrigin).count();
+    event.duration = chrono::duration_cast<chrono::nanoseconds>(end - begin).count();
+    localPhaseBuffer->events.push_back(event);
+}
+
+/**
+ * Times the scope it is declared in, when phase_trace_file is set ; a test of a global otherwise
+ */
+struct ScopedPhase {
+    const char * name;
+    bool active;
+    chrono::steady_clock::time_point begin;
+
+    ScopedPhase(const char * phaseName) : name(phaseName), active(!phase_trace_file.empty())
+    {
+        if (active) {
+            begin = chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedPhase()
+    {
+        if (active) {
+            recordPhase(name, begin, chrono::steady_clock::now());
+        }
+    }
+};
+
+/**
+ * Write the events of all the threads in the Chrome trace-event format (chrome://tracing, Perfetto)
+ * 
+ * To be called once the traced threads are done.
+ * 
+ * @param[in] fileName Name of the JSON file
+ * @return false if one error occured, true otherwise
+ */
+bool exportPhaseTrace(string fileName)
+{
+    ofstream traceStream(fileName, ios::trunc);
+    if (!traceStream) {
+        generateError("phases.h","exportPhaseTrace","impossible to open a file","file_name",fileName);
+        return false;
+    }
+
+    bool first = true;
+    traceStream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (PhaseBuffer * buffer = phaseBuffers.load(memory_order_acquire); buffer != NULL; buffer = buffer->next) {
+        traceStream << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                    << ",\"args\":{\"name\":\"solver " << buffer->tid << "\",\"dropped_events\":" << buffer->dropped << "}}";
+        first = false;
+        for (PhaseEvent & event : buffer->events) {
+            /// timestamps in microseconds
+            traceStream << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                        << ",\"ts\":" << event.begin/1000. << ",\"dur\":" << event.duration/1000. << "}";
+        }
+    }
+    traceStream << "\n]}\n";
+    return true;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*****************************************************************************
+ * Random generator of the heuristics, one independent state per thread      *
+ *****************************************************************************/
+
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+#include <stdlib.h>
+#include <string.h>
+
+/// size of the state of the generator, the one of rand() in the glibc (additive feedback, degree 31)
+#define RANDOM_STATE_SIZE 128
+
+thread_local char randomStateBuffer[RANDOM_STATE_SIZE];
+thread_local struct random_data randomState;
+thread_local bool randomSeeded = false;
+
+/// State of the generator of a thread, independent of its address : the pointers of random_data are kept as offsets
+struct RandomSnapshot {
+    char buffer[RANDOM_STATE_SIZE];
+    int frontOffset;
+    int rearOffset;
+};
+
+/**
+ * Seed the generator of the calling thread, as srand() does for rand()
+ *
+ * @param[in] randomSeed The seed, the same seed gives the same sequence as rand() after srand(randomSeed)
+ */
+void seedRandom(unsigned int randomSeed)
+{
+    memset(&randomState, 0, sizeof(randomState));
+    initstate_r(randomSeed, randomStateBuffer, RANDOM_STATE_SIZE, &randomState);
+    randomSeeded = true;
+}
+
+/**
+ * Next number of the generator of the calling thread, in [0,RAND_MAX], as rand()
+ * The threads running heuristics concurrently don't share any state, each run stays reproducible from its seed
+ */
+inline int randomInt()
+{
+    if (!randomSeeded) {
+        seedRandom(1);
+    }
+    int32_t result;
+    random_r(&randomState, &result);
+    return result;
+}
+
+/**
+ * Save the state of the generator of the calling thread (see checkpoint.h)
+ *
+ * @param[out] snapshot The state
+ */
+void saveRandom(RandomSnapshot & snapshot)
+{
+    if (!randomSeeded) {
+        seedRandom(1);
+    }
+    memcpy(snapshot.buffer, randomStateBuffer, RANDOM_STATE_SIZE);
+    snapshot.frontOffset = randomState.fptr - randomState.state;
+    snapshot.rearOffset = randomState.rptr - randomState.state;
+}
+
+/**
+ * Restore a saved state in the generator of the calling thread, it then continues the saved sequence
+ *
+ * @param[in] snapshot The state
+ */
+void restoreRandom(RandomSnapshot & snapshot)
+{
+    seedRandom(1); /// the type, degree and bounds of the state only depend on its size
+    memcpy(randomStateBuffer, snapshot.buffer, RANDOM_STATE_SIZE);
+    randomState.fptr = randomState.state + snapshot.frontOffset;
+    randomState.rptr = randomState.state + snapshot.rearOffset;
+}
+
+#endif
@@ -0,0 +1,271 @@
+/*****************************************************************************
+ * End-to-end performance regression harness, compared to a JSON baseline   *
+ *****************************************************************************/
+
+#ifndef _REGRESSION_H_
+#define _REGRESSION_H_
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "files.h"
+#include "trace.h"
+#include "aco.h"
+#include "ils.h"
+
+using namespace std;
+
+/// times to target below this slack (ms) are considered as noise
+#define REGRESSION_TIME_SLACK_MS 5.
+
+/// One run of the regression harness : a heuristic, on an instance, with a fixed seed and evaluation budget
+struct RegressionCase {
+    string instanceName;
+    string algorithm; /// ACO or ILS
+    unsigned int runSeed;
+    double maxEvaluations;
+    int target; /// WCT whose time to reach is measured
+    /// baseline measures
+    int wct;
+    double evaluationsPerSecond;
+    double timeToTarget; /// ms, negative if the target was not reached
+};
+
+/**
+ * Read the baseline file : the tolerance and the cases with their reference measures
+ *
+ * @param[in] fileName Name of the baseline (JSON)
+ * @param[out] cases The cases
+ * @param[out] tolerance Relative tolerance on the throughput and the time to target
+ * @return false if one error occured, true otherwise
+ */
+bool readBaseline(string fileName, vector<RegressionCase> & cases, double & tolerance)
+{
+    ifstream baselineStream(fileName);
+    if (!baselineStream) {
+        generateError("regression.h","readBaseline","impossible to open a file","file_name",fileName);
+        return false;
+    }
+    stringstream buffer;
+    buffer << baselineStream.rdbuf();
+    string text = buffer.str();
+
+    size_t casesBegin = text.find("\"cases\"");
+    if (casesBegin == string::npos) {
+        generateError("regression.h","readBaseline","no cases in the baseline","file_name",fileName);
+        return false;
+    }
+    string header = text.substr(0, casesBegin);
+    string value;
+    if (jsonField(header,"tolerance",value)) {
+        tolerance = atof(value.c_str());
+    }
+
+    cases.clear();
+    size_t objectBegin = text.find('{', casesBegin);
+    while (objectBegin != string::npos) {
+        size_t objectEnd = text.find('}', objectBegin);
+        if (objectEnd == string::npos) {
+            generateError("regression.h","readBaseline","unterminated case","file_name",fileName);
+            return false;
+        }
+        string object = text.substr(objectBegin, objectEnd - objectBegin + 1);
+        RegressionCase regressionCase;
+        string fields[8];
+        const char * keys[8] = {"instance", "algorithm", "seed", "max_evaluations", "target", "wct", "evaluations_per_second", "time_to_target_ms"};
+        for (int k = 0; k < 8; k++) {
+            if (!jsonField(object,keys[k],fields[k])) {
+                generateError("regression.h","readBaseline","missing field in a case","field",keys[k]);
+                return false;
+            }
+        }
+        regressionCase.instanceName = fields[0];
+        regressionCase.algorithm = fields[1];
+        regressionCase.runSeed = strtoul(fields[2].c_str(), NULL, 10);
+        regressionCase.maxEvaluations = atof(fields[3].c_str());
+        regressionCase.target = atoi(fields[4].c_str());
+        regressionCase.wct = atoi(fields[5].c_str());
+        regressionCase.evaluationsPerSecond = atof(fields[6].c_str());
+        regressionCase.timeToTarget = atof(fields[7].c_str());
+        if (regressionCase.algorithm != "ACO" && regressionCase.algorithm != "ILS") {
+            generateError("regression.h","readBaseline","algorithm should be ACO or ILS","algorithm",regressionCase.algorithm);
+            return false;
+        }
+        cases.push_back(regressionCase);
+        objectBegin = text.find('{', objectEnd);
+    }
+    return true;
+}
+
+/**
+ * Write the baseline file, atomically (temporary file renamed)
+ *
+ * @param[in] fileName Name of the baseline (JSON)
+ * @param[in] cases The cases, with their new reference measures
+ * @param[in] tolerance Relative tolerance on the throughput and the time to target
+ * @return false if one error occured, true otherwise
+ */
+bool writeBaseline(string fileName, vector<RegressionCase> & cases, double tolerance)
+{
+    string temporaryName = fileName + ".tmp";
+    ofstream baselineStream(temporaryName);
+    if (!baselineStream) {
+        generateError("regression.h","writeBaseline","impossible to open a file","file_name",temporaryName);
+        return false;
+    }
+    baselineStream << "{\n  \"tolerance\": " << tolerance << ",\n  \"cases\": [\n";
+    for (size_t c = 0; c < cases.size(); c++) {
+        RegressionCase & regressionCase = cases[c];
+        baselineStream << "    {\"instance\": \"" << regressionCase.instanceName << "\", \"algorithm\": \"" << regressionCase.algorithm
+                       << "\", \"seed\": " << regressionCase.runSeed << ", \"max_evaluations\": " << (long long)regressionCase.maxEvaluations
+                       << ", \"target\": " << regressionCase.target << ", \"wct\": " << regressionCase.wct
+                       << ", \"evaluations_per_second\": " << fixed << setprecision(0) << regressionCase.evaluationsPerSecond
+                       << ", \"time_to_target_ms\": " << setprecision(3) << regressionCase.timeToTarget << defaultfloat << setprecision(6)
+                       << "}" << (c + 1 < cases.size() ? "," : "") << "\n";
+    }
+    baselineStream << "  ]\n}\n";
+    baselineStream.close();
+    if (!baselineStream || rename(temporaryName.c_str(), fileName.c_str()) != 0) {
+        generateError("regression.h","writeBaseline","impossible to write the baseline","file_name",fileName);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Run one case with the default parameters of its heuristic, and measure it
+ *
+ * @param[in] regressionCase The case (instance, algorithm, seed, budget, target)
+ * @param[out] measured The same case, with the measures of this run
+ * @return false if one error occured, true otherwise
+ */
+bool runRegressionCase(RegressionCase & regressionCase, RegressionCase & measured)
+{
+    measured = regressionCase;
+    instance_file = &regressionCase.instanceName[0];
+    if (!loadInstance(regressionCase.instanceName)) {
+        return false;
+    }
+
+    bool readParams = false;
+    int noTarget = 0; /// the run goes on until its budget, the target is only looked for in the trace
+    double timeLimit = 3600*1000.; /// safety deadline, the budget is the real limit
+    max_evaluations = regressionCase.maxEvaluations;
+    seed = regressionCase.runSeed;
+    seedRandom(seed);
+    traceTarget = regressionCase.target > 0 ? regressionCase.target : INT_MIN;
+
+    if (regressionCase.algorithm == "ACO") {
+        sls_global = ACO;
+        if (!ACO_heuristic(readParams,noTarget,timeLimit)) { return false; }
+    } else {
+        sls_global = ILS;
+        if (!ILS_heuristic(readParams,noTarget,timeLimit)) { return false; }
+    }
+
+    measured.wct = lastRun.bestWCT;
+    measured.evaluationsPerSecond = lastRun.time > 0 ? lastRun.evaluations / (lastRun.time / 1000.) : 0.;
+    if (measured.target <= 0) { /// new case : its target is the final WCT of this run
+        measured.target = measured.wct;
+    }
+    measured.timeToTarget = traceTargetTime;
+    if (regressionCase.target <= 0 && nbTraceEvents > 0) { /// the target is the last improvement, always kept in the trace
+        measured.timeToTarget = traceEvents[nbKeptTraceEvents()-1].time;
+    }
+    return true;
+}
+
+/**
+ * Regression mode : run every case of the baseline and compare the measures to it
+ *
+ * A case regresses if its final WCT is worse than the baseline (the runs are deterministic for a seed and an evaluation budget),
+ * if its throughput dropped by more than the tolerance, or if it reaches the target more than the tolerance later (or not at all).
+ * With update, the measures replace the baseline instead, the targets are kept (or set to the final WCT of new cases).
+ *
+ * Arguments after --regression <baseline> : [--tolerance <fraction>] [--update_baseline]
+ *
+ * @return the exit status : 0 if no case regressed, 1 otherwise or if one error occured
+ */
+int runRegression()
+{
+    string baselineName = argv_global[2];
+    double tolerance = 0.25;
+    bool toleranceGiven = false;
+    bool update = false;
+    for (int i = 3; i < argc_global; i++) {
+        if (argv_global[i] == "--tolerance" && i+1 < argc_global) {
+            tolerance = atof(argv_global[++i].c_str());
+            toleranceGiven = true;
+        } else if (argv_global[i] == "--update_baseline") {
+            update = true;
+        } else {
+            generateError("regression.h","runRegression","argument not recognized","argument",argv_global[i]);
+            return 1;
+        }
+    }
+
+    vector<RegressionCase> cases;
+    double baselineTolerance = tolerance;
+    if (!readBaseline(baselineName,cases,baselineTolerance)) {
+        return 1;
+    }
+    if (!toleranceGiven) {
+        tolerance = baselineTolerance;
+    }
+
+    quiet = true;
+    int nbRegressions = 0;
+    vector<RegressionCase> measures (cases.size());
+
+    cout << left << setw(22) << "instance" << setw(6) << "sls" << right << setw(6) << "seed"
+         << setw(12) << "wct" << setw(12) << "base wct" << setw(12) << "evals/s" << setw(12) << "base"
+         << setw(12) << "ttt ms" << setw(12) << "base" << "  status\n";
+
+    for (size_t c = 0; c < cases.size(); c++) {
+        RegressionCase & base = cases[c];
+        RegressionCase & measured = measures[c];
+        if (!runRegressionCase(base,measured)) {
+            return 1;
+        }
+
+        string status = "ok";
+        if (measured.wct > base.wct) {
+            status = "REGRESSION (wct)";
+        } else if (measured.evaluationsPerSecond < base.evaluationsPerSecond * (1. - tolerance)) {
+            status = "REGRESSION (throughput)";
+        } else if (base.timeToTarget >= 0 && (measured.timeToTarget < 0
+                   || measured.timeToTarget > base.timeToTarget * (1. + tolerance) + REGRESSION_TIME_SLACK_MS)) {
+            status = "REGRESSION (time to target)";
+        }
+        if (update) {
+            status = "updated";
+        } else if (status != "ok") {
+            nbRegressions ++;
+        }
+
+        cout << left << setw(22) << base.instanceName << setw(6) << base.algorithm << right << setw(6) << base.runSeed
+             << setw(12) << measured.wct << setw(12) << base.wct
+             << fixed << setprecision(0) << setw(12) << measured.evaluationsPerSecond << setw(12) << base.evaluationsPerSecond
+             << setprecision(1) << setw(12) << measured.timeToTarget << setw(12) << base.timeToTarget << defaultfloat << setprecision(6)
+             << "  " << status << "\n";
+    }
+
+    if (update) {
+        if (!writeBaseline(baselineName,measures,tolerance)) {
+            return 1;
+        }
+        cout << "baseline " << baselineName << " updated" << endl;
+        return 0;
+    }
+    cout << nbRegressions << " regression(s) on " << cases.size() << " case(s), tolerance " << tolerance << endl;
+    return nbRegressions == 0 ? 0 : 1;
+}
+
+#endif
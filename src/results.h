@@ -0,0 +1,553 @@
+/*************************************************************************
+ * Results sink : one writer thread, lock-free queue, CSV/JSONL records   *
+ *************************************************************************/
+
+#ifndef _RESULTS_H_
+#define _RESULTS_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <map>
+#include <cstring>
+#include <cctype>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "budget.h"
+
+using namespace std;
+
+/// the writer flushes its buffer once it holds RESULTS_FLUSH_BYTES, or every RESULTS_FLUSH_MS
+#define RESULTS_FLUSH_BYTES (1 << 16)
+#define RESULTS_FLUSH_MS 1000
+/// period of the writer thread polling the queue
+#define RESULTS_POLL_MS 10
+
+/// One line of the results file
+struct ResultRecord {
+    string instance;
+    string algorithm;
+    unsigned int seed;
+    RunResult run;
+    ResultRecord * next; /// link of the queue
+};
+
+atomic<ResultRecord *> pendingResults (NULL); /// lock-free stack of the records not written yet, most recent first
+atomic<bool> resultsWriterStop (false);
+thread resultsWriter;
+ofstream resultsStream;
+bool resultsJSONL = false;
+
+/**
+ * Save the result of the run of a heuristic into the global lastRun
+ * 
+ * @param[in] bestSol Best solution found
+ * @param[in] bestWCT Its WCT
+ * @param[in] timeToBest Time when bestSol was found, ms
+ * @param[in] time Duration of the run (wall time), ms ; its CPU time is read here
+ */
+void saveRunResult(vector<int> & bestSol, int bestWCT, double timeToBest, double time)
+{
+    lastRun.bestSol = bestSol;
+    lastRun.bestWCT = bestWCT;
+    lastRun.timeToBest = timeToBest;
+    lastRun.time = time;
+    lastRun.cpuTime = runCPUTime();
+    lastRun.evaluations = instance.getNbEvaluations();
+}
+
+/**
+ * Escape a string for a JSON value
+ */
+string jsonEscape(const string & value)
+{
+    string escaped;
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if ((unsigned char)c < 0x20) {
+            escaped += ' ';
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * Format a string as a CSV field (RFC 4180) : quoted, with its quotes doubled, if it holds a comma, a quote or a line break
+ */
+string csvField(const string & value)
+{
+    if (value.find_first_of(",\"\r\n") == string::npos) {
+        return value;
+    }
+    string quoted = "\"";
+    for (char c : value) {
+        quoted += c;
+        if (c == '"') {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+/**
+ * Value of a field of a flat JSON object written by this program (a case of the regression baseline) : the key is searched
+ * anywhere in the text, the input of a client goes through parseJSONObject instead
+ * The escapes of a string value are decoded (\uXXXX is kept as is).
+ *
+ * @param[in] object Text of the object
+ * @param[in] key Name of the field
+ * @param[out] value Its value, without quotes
+ * @return false if the field is missing, true otherwise
+ */
+bool jsonField(string & object, string key, string & value)
+{
+    size_t position = object.find("\"" + key + "\"");
+    if (position == string::npos) {
+        return false;
+    }
+    position = object.find(':', position);
+    if (position == string::npos) {
+        return false;
+    }
+    position = object.find_first_not_of(" \t\n\r", position + 1);
+    if (position == string::npos) {
+        return false;
+    }
+    if (object[position] == '"') {
+        value = "";
+        for (position++; position < object.size() && object[position] != '"'; position++) {
+            if (object[position] != '\\' || position + 1 == object.size()) {
+                value += object[position];
+                continue;
+            }
+            char escaped = object[++position];
+            value += escaped == 'n' ? '\n' : escaped == 't' ? '\t' : escaped == 'r' ? '\r' : escaped == 'u' ? '\\' : escaped;
+            if (escaped == 'u') {
+                value += 'u';
+            }
+        }
+        return position < object.size();
+    }
+    size_t end = object.find_first_of(",}\n", position);
+    value = object.substr(position, end - position);
+    return true;
+}
+
+/// One value of a JSON object : its type and its text (decoded for a string, as written otherwise)
+struct JSONValue {
+    char type; /// 's'tring, 'n'umber, 'b'oolean, 'z' for null, 'o'bject, 'a'rray
+    string text;
+};
+
+/// nesting of the objects and arrays accepted in a JSON value
+#define JSON_MAX_DEPTH 32
+
+void skipJSONBlanks(const string & text, size_t & position)
+{
+    while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\r' || text[position] == '\n')) {
+        position ++;
+    }
+}
+
+/**
+ * Read a JSON string (RFC 8259), its escapes decoded (\uXXXX in UTF-8)
+ *
+ * @param[in] text The JSON text
+ * @param[in,out] position On the opening quote, after the closing one on return
+ * @param[out] value The string
+ * @return false if the string is malformed, true otherwise
+ */
+bool parseJSONString(const string & text, size_t & position, string & value)
+{
+    value = "";
+    if (position >= text.size() || text[position] != '"') {
+        return false;
+    }
+    for (position++; position < text.size(); position++) {
+        unsigned char c = text[position];
+        if (c == '"') {
+            position ++;
+            return true;
+        }
+        if (c < 0x20) {
+            return false;
+        }
+        if (c != '\\') {
+            value += c;
+            continue;
+        }
+        if (++position >= text.size()) {
+            return false;
+        }
+        char escaped = text[position];
+        const char * simple = strchr("\"\\/bfnrt", escaped);
+        if (escaped != 0 && simple != NULL) {
+            value += "\"\\/\b\f\n\r\t"[simple - "\"\\/bfnrt"];
+            continue;
+        }
+        if (escaped != 'u' || position + 4 >= text.size()) {
+            return false;
+        }
+        unsigned long code = 0;
+        for (int k = 1; k <= 4; k++) {
+            if (!isxdigit((unsigned char)text[position + k])) {
+                return false;
+            }
+        }
+        code = strtoul(text.substr(position + 1, 4).c_str(), NULL, 16);
+        position += 4;
+        if (code >= 0xD800 && code <= 0xDBFF) { /// high surrogate, its low one has to follow
+            if (position + 6 >= text.size() || text[position + 1] != '\\' || text[position + 2] != 'u') {
+                return false;
+            }
+            for (int k = 3; k <= 6; k++) {
+                if (!isxdigit((unsigned char)text[position + k])) {
+                    return false;
+                }
+            }
+            unsigned long low = strtoul(text.substr(position + 3, 4).c_str(), NULL, 16);
+            if (low < 0xDC00 || low > 0xDFFF) {
+                return false;
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            position += 6;
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            return false;
+        }
+        if (code < 0x80) {
+            value += (char)code;
+        } else if (code < 0x800) {
+            value += (char)(0xC0 | (code >> 6));
+            value += (char)(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            value += (char)(0xE0 | (code >> 12));
+            value += (char)(0x80 | ((code >> 6) & 0x3F));
+            value += (char)(0x80 | (code & 0x3F));
+        } else {
+            value += (char)(0xF0 | (code >> 18));
+            value += (char)(0x80 | ((code >> 12) & 0x3F));
+            value += (char)(0x80 | ((code >> 6) & 0x3F));
+            value += (char)(0x80 | (code & 0x3F));
+        }
+    }
+    return false;
+}
+
+/**
+ * Read a JSON value (RFC 8259) : string, number, true, false, null, or an object or array kept as written
+ *
+ * @param[in] text The JSON text
+ * @param[in,out] position On the first character of the value (blanks skipped), after it on return
+ * @param[out] value The value
+ * @param[in] depth Nesting of the value
+ * @return false if the value is malformed, true otherwise
+ */
+bool parseJSONValue(const string & text, size_t & position, JSONValue & value, int depth)
+{
+    skipJSONBlanks(text, position);
+    if (position >= text.size() || depth > JSON_MAX_DEPTH) {
+        return false;
+    }
+    size_t begin = position;
+    char c = text[position];
+    if (c == '"') {
+        value.type = 's';
+        return parseJSONString(text, position, value.text);
+    }
+    if (c == '{' || c == '[') {
+        char close = c == '{' ? '}' : ']';
+        value.type = c == '{' ? 'o' : 'a';
+        position ++;
+        skipJSONBlanks(text, position);
+        if (position < text.size() && text[position] == close) {
+            position ++;
+            value.text = text.substr(begin, position - begin);
+            return true;
+        }
+        while (true) {
+            JSONValue element;
+            if (c == '{') {
+                skipJSONBlanks(text, position);
+                string key;
+                if (!parseJSONString(text, position, key)) {
+                    return false;
+                }
+                skipJSONBlanks(text, position);
+                if (position >= text.size() || text[position] != ':') {
+                    return false;
+                }
+                position ++;
+            }
+            if (!parseJSONValue(text, position, element, depth + 1)) {
+                return false;
+            }
+            skipJSONBlanks(text, position);
+            if (position < text.size() && text[position] == ',') {
+                position ++;
+            } else if (position < text.size() && text[position] == close) {
+                position ++;
+                value.text = text.substr(begin, position - begin);
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+    for (const char * literal : {"true", "false", "null"}) {
+        if (text.compare(position, strlen(literal), literal) == 0) {
+            position += strlen(literal);
+            value.type = literal[0] == 'n' ? 'z' : 'b';
+            value.text = literal;
+            return true;
+        }
+    }
+    /// number : -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    value.type = 'n';
+    if (text[position] == '-') {
+        position ++;
+    }
+    if (position < text.size() && text[position] == '0') {
+        position ++;
+    } else if (position < text.size() && isdigit((unsigned char)text[position])) {
+        while (position < text.size() && isdigit((unsigned char)text[position])) { position ++; }
+    } else {
+        return false;
+    }
+    if (position < text.size() && text[position] == '.') {
+        position ++;
+        if (position >= text.size() || !isdigit((unsigned char)text[position])) {
+            return false;
+        }
+        while (position < text.size() && isdigit((unsigned char)text[position])) { position ++; }
+    }
+    if (position < text.size() && (text[position] == 'e' || text[position] == 'E')) {
+        position ++;
+        if (position < text.size() && (text[position] == '+' || text[position] == '-')) {
+            position ++;
+        }
+        if (position >= text.size() || !isdigit((unsigned char)text[position])) {
+            return false;
+        }
+        while (position < text.size() && isdigit((unsigned char)text[position])) { position ++; }
+    }
+    value.text = text.substr(begin, position - begin);
+    return true;
+}
+
+/**
+ * Read a JSON object (a request of a client of the solver daemon) : only its top-level fields are returned,
+ * the whole text has to be one valid object, without duplicated keys
+ *
+ * @param[in] text The JSON text
+ * @param[out] fields The values of the object, by key
+ * @param[out] message Why the text is not a valid object
+ * @return false if the text is not a valid JSON object, true otherwise
+ */
+bool parseJSONObject(const string & text, map<string, JSONValue> & fields, string & message)
+{
+    fields.clear();
+    size_t position = 0;
+    skipJSONBlanks(text, position);
+    if (position >= text.size() || text[position] != '{') {
+        message = "a request is a JSON object";
+        return false;
+    }
+    position ++;
+    skipJSONBlanks(text, position);
+    bool empty = position < text.size() && text[position] == '}';
+    if (empty) {
+        position ++;
+    }
+    while (!empty) {
+        string key;
+        JSONValue value;
+        skipJSONBlanks(text, position);
+        if (!parseJSONString(text, position, key)) {
+            message = "malformed JSON : a key is expected at character " + to_string(position + 1);
+            return false;
+        }
+        skipJSONBlanks(text, position);
+        if (position >= text.size() || text[position] != ':') {
+            message = "malformed JSON : ':' is expected at character " + to_string(position + 1);
+            return false;
+        }
+        position ++;
+        if (!parseJSONValue(text, position, value, 1)) {
+            message = "malformed JSON : invalid value of " + key;
+            return false;
+        }
+        if (!fields.emplace(key, value).second) {
+            message = "duplicated field " + key;
+            return false;
+        }
+        skipJSONBlanks(text, position);
+        if (position < text.size() && text[position] == ',') {
+            position ++;
+        } else if (position < text.size() && text[position] == '}') {
+            position ++;
+            break;
+        } else {
+            message = "malformed JSON : ',' or '}' is expected at character " + to_string(position + 1);
+            return false;
+        }
+    }
+    skipJSONBlanks(text, position);
+    if (position != text.size()) {
+        message = "malformed JSON : text after the object at character " + to_string(position + 1);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Format a record as a CSV or JSONL line (end line included)
+ * 
+ * @param[in] record The record
+ * @param[in] jsonl true for JSONL, false for CSV
+ * @return the formatted line
+ */
+string formatResult(ResultRecord & record, bool jsonl)
+{
+    ostringstream line;
+    if (jsonl) {
+        line << "{\"instance\":\"" << jsonEscape(record.instance) << "\",\"algorithm\":\"" << record.algorithm
+             << "\",\"seed\":" << record.seed << ",\"best_wct\":" << record.run.bestWCT
+             << ",\"time_to_best_ms\":" << record.run.timeToBest << ",\"time_ms\":" << record.run.time << ",\"cpu_time_ms\":" << record.run.cpuTime
+             << ",\"evaluations\":" << record.run.evaluations << ",\"permutation\":[";
+        for (size_t i = 1; i < record.run.bestSol.size(); i++) {
+            line << (i > 1 ? "," : "") << record.run.bestSol[i];
+        }
+        line << "]}\n";
+    } else {
+        line << csvField(record.instance) << "," << csvField(record.algorithm) << "," << record.seed << "," << record.run.bestWCT << ","
+             << record.run.timeToBest << "," << record.run.time << "," << record.run.cpuTime << "," << record.run.evaluations << ",";
+        for (size_t i = 1; i < record.run.bestSol.size(); i++) {
+            line << (i > 1 ? " " : "") << record.run.bestSol[i];
+        }
+        line << "\n";
+    }
+    return line.str();
+}
+
+/**
+ * Take all the pending records and append them, oldest first, to the buffer
+ * 
+ * @param[in,out] buffer Text waiting to be written
+ */
+void drainResults(string & buffer)
+{
+    ResultRecord * stack = pendingResults.exchange(NULL, memory_order_acquire);
+    ResultRecord * ordered = NULL;
+    ResultRecord * next;
+
+    /// the stack is most recent first, reverse it
+    while (stack != NULL) {
+        next = stack->next;
+        stack->next = ordered;
+        ordered = stack;
+        stack = next;
+    }
+    while (ordered != NULL) {
+        buffer += formatResult(*ordered, resultsJSONL);
+        next = ordered->next;
+        delete ordered;
+        ordered = next;
+    }
+}
+
+/**
+ * Body of the writer thread : poll the queue, write by batches
+ */
+void resultsWriterLoop()
+{
+    string buffer;
+    auto lastFlush = chrono::steady_clock::now();
+    bool stop = false;
+
+    while (!stop) {
+        stop = resultsWriterStop.load(memory_order_acquire);
+        drainResults(buffer);
+        if (!buffer.empty() && (stop || buffer.size() >= RESULTS_FLUSH_BYTES
+            || chrono::steady_clock::now() - lastFlush >= chrono::milliseconds(RESULTS_FLUSH_MS))) {
+            resultsStream.write(buffer.data(), buffer.size());
+            resultsStream.flush();
+            buffer.clear();
+            lastFlush = chrono::steady_clock::now();
+        }
+        if (!stop) {
+            this_thread::sleep_for(chrono::milliseconds(RESULTS_POLL_MS));
+        }
+    }
+}
+
+/**
+ * Open the results file in append mode and start the writer thread
+ * 
+ * The format is JSONL if the name ends with .jsonl, CSV otherwise (with a header line if the file is new).
+ * 
+ * @param[in] fileName Path of the results file
+ * @return false if one error occured, true otherwise
+ */
+bool startResultsWriter(string fileName)
+{
+    resultsJSONL = fileName.size() >= 6 && fileName.compare(fileName.size()-6,6,".jsonl") == 0;
+
+    resultsStream.open(fileName, ios::app);
+    if (!resultsStream) {
+        generateError("results.h","startResultsWriter","impossible to open a file","file_name",fileName);
+        return false;
+    }
+    resultsStream.seekp(0, ios::end);
+    if (!resultsJSONL && resultsStream.tellp() == 0) {
+        resultsStream << "instance,algorithm,seed,best_wct,time_to_best_ms,time_ms,cpu_time_ms,evaluations,permutation\n";
+    }
+
+    resultsWriterStop = false;
+    resultsWriter = thread(resultsWriterLoop);
+    return true;
+}
+
+/**
+ * Queue the result of a run, never blocks : the record is pushed on a lock-free stack
+ * 
+ * @param[in] instanceName Name of the instance
+ * @param[in] run Result of the run
+ */
+void pushResult(string instanceName, RunResult & run)
+{
+    ResultRecord * record = new ResultRecord;
+    ostringstream algorithm;
+    algorithm << sls_global;
+
+    record->instance = instanceName;
+    record->algorithm = algorithm.str();
+    record->seed = seed;
+    record->run = run;
+    record->next = pendingResults.load(memory_order_relaxed);
+    while (!pendingResults.compare_exchange_weak(record->next, record, memory_order_release, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * Stop the writer thread once every queued record is written, and close the file
+ */
+void stopResultsWriter()
+{
+    if (resultsWriter.joinable()) {
+        resultsWriterStop = true;
+        resultsWriter.join();
+        resultsStream.close();
+    }
+}
+
+#endif
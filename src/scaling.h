@@ -0,0 +1,245 @@
+/*****************************************************************************
+ * Strong and weak scaling benchmark of the parallel paths of the solver     *
+ *****************************************************************************/
+
+#ifndef _SCALING_H_
+#define _SCALING_H_
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "files.h"
+#include "lowerBound.h"
+#include "experiment.h"
+
+using namespace std;
+
+/// repetitions of the lower bound computation, the fastest one is kept
+#define SCALING_LB_REPETITIONS 3
+
+/// One measure : a parallel path, on an instance, with a number of threads
+struct ScalingRecord {
+    string instanceName;
+    int nbJobs;
+    int nbMachines;
+    string path; /// "runs" (experiment runner) or "lower_bound"
+    string mode; /// "strong" (fixed total work) or "weak" (work proportional to the threads)
+    int nbThreads;
+    int nbRuns;
+    double wallTime; /// ms
+    double speedup; /// for weak scaling, the scaled speedup (threads * efficiency)
+    double efficiency;
+    double timeToTarget; /// ms since the beginning of the batch, negative if the target was not reached
+    double evaluationsPerSecond;
+};
+
+/**
+ * Thread counts of the sweep : the powers of two below maxThreads, and maxThreads
+ */
+vector<int> scalingThreadCounts(int maxThreads)
+{
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+void printScalingRecord(ScalingRecord & record)
+{
+    cout << left << setw(16) << record.instanceName << setw(13) << record.path << setw(8) << record.mode << right
+         << setw(8) << record.nbThreads << setw(6) << record.nbRuns
+         << fixed << setprecision(1) << setw(12) << record.wallTime
+         << setprecision(2) << setw(9) << record.speedup << setw(8) << record.efficiency
+         << setprecision(1) << setw(12) << record.timeToTarget
+         << setprecision(0) << setw(14) << record.evaluationsPerSecond
+         << defaultfloat << setprecision(6) << "\n";
+}
+
+/**
+ * Write the measures as one JSON array
+ *
+ * @param[in] fileName Name of the output file
+ * @param[in] records The measures
+ * @return false if one error occured, true otherwise
+ */
+bool writeScalingJSON(string fileName, vector<ScalingRecord> & records)
+{
+    ofstream jsonStream(fileName);
+    if (!jsonStream) {
+        generateError("scaling.h","writeScalingJSON","impossible to open a file","file_name",fileName);
+        return false;
+    }
+    jsonStream << "[\n";
+    for (size_t r = 0; r < records.size(); r++) {
+        ScalingRecord & record = records[r];
+        jsonStream << "  {\"instance\":\"" << record.instanceName << "\",\"jobs\":" << record.nbJobs << ",\"machines\":" << record.nbMachines
+                   << ",\"algorithm\":\"" << sls_global << "\",\"path\":\"" << record.path << "\",\"mode\":\"" << record.mode
+                   << "\",\"threads\":" << record.nbThreads << ",\"runs\":" << record.nbRuns
+                   << ",\"wall_ms\":" << record.wallTime << ",\"speedup\":" << record.speedup << ",\"efficiency\":" << record.efficiency
+                   << ",\"time_to_target_ms\":" << record.timeToTarget << ",\"evaluations_per_second\":" << record.evaluationsPerSecond
+                   << "}" << (r + 1 < records.size() ? "," : "") << "\n";
+    }
+    jsonStream << "]\n";
+    return true;
+}
+
+/**
+ * Scaling mode : for each instance matching the pattern, sweep the thread counts 1..maxThreads on
+ *      - the experiment runner (executeRuns), strong scaling (runsPerThread*maxThreads runs whatever the threads)
+ *        and weak scaling (runsPerThread runs per thread), each run bounded by max_evaluations and timeLimit
+ *      - the lower bound computation (computeLowerBound), strong scaling
+ * The target of an instance is the median final WCT of runsPerThread sequential calibration runs; the time to target
+ * of a batch is the first time one of its runs reached it. The seeds are the same for every thread count.
+ *
+ * @param[in] pattern Directory or glob pattern of the instances
+ * @param[in] maxThreads Largest thread count
+ * @param[in] runsPerThread Runs per thread (weak scaling), per thread of maxThreads (strong scaling)
+ * @param[in] timeLimit Time limit of each run, ms
+ * @return false if one error occured, true otherwise
+ */
+bool runScaling(string pattern, int maxThreads, int runsPerThread, double timeLimit)
+{
+    vector<string> fileNames;
+    vector<string> instanceNames;
+    int nbFiles = 0;
+    if (!fillFileNames(pattern,fileNames,instanceNames,nbFiles)) {
+        return false;
+    }
+
+    quiet = true;
+    results_file = "";
+    trace_file = "";
+    vector<int> threadCounts = scalingThreadCounts(maxThreads);
+    vector<ScalingRecord> records;
+    vector<double> runTimes;
+    vector<RunResult> runResults;
+    vector<double> targetTimes;
+    int scalingGeneration = cancelGeneration.load();
+
+    cout << sls_global << ", up to " << maxThreads << " threads, " << runsPerThread << " run(s) per thread, "
+         << max_evaluations << " evaluations per run (0 : no budget)\n";
+    cout << left << setw(16) << "instance" << setw(13) << "path" << setw(8) << "mode" << right << setw(8) << "threads"
+         << setw(6) << "runs" << setw(12) << "wall ms" << setw(9) << "speedup" << setw(8) << "eff."
+         << setw(12) << "ttt ms" << setw(14) << "evals/s" << "\n";
+
+    for (int i = 0; i < nbFiles; i++) {
+        instance_file = &fileNames[i][0];
+        if (!loadInstance(fileNames[i])) {
+            return false;
+        }
+
+        ScalingRecord record;
+        record.instanceName = instanceNames[i];
+        record.nbJobs = instance.getNbJob();
+        record.nbMachines = instance.getNbMac();
+
+        /// lower bound, strong scaling
+        record.path = "lower_bound";
+        record.mode = "strong";
+        record.nbRuns = 1;
+        record.timeToTarget = -1.;
+        record.evaluationsPerSecond = 0.;
+        double sequentialTime = 0.;
+        for (int t : threadCounts) {
+            double bestTime = -1.;
+            for (int repetition = 0; repetition < SCALING_LB_REPETITIONS; repetition++) {
+                auto start = chrono::steady_clock::now();
+                if (!computeLowerBound(t)) {
+                    return false;
+                }
+                double time = chrono::duration<double, std::milli>(chrono::steady_clock::now() - start).count();
+                if (bestTime < 0 || time < bestTime) {
+                    bestTime = time;
+                }
+            }
+            if (t == 1) {
+                sequentialTime = bestTime;
+            }
+            record.nbThreads = t;
+            record.wallTime = bestTime;
+            record.speedup = bestTime > 0 ? sequentialTime / bestTime : 1.;
+            record.efficiency = record.speedup / t;
+            printScalingRecord(record);
+            records.push_back(record);
+        }
+
+        /// calibration of the target
+        vector<int> calibrationRuns = allRuns(runsPerThread);
+        if (!executeRuns(instanceNames[i],0,false,timeLimit,runsPerThread,calibrationRuns,1,1,runTimes,runResults,targetTimes)) {
+            return false;
+        }
+        if (cancelGeneration.load() != scalingGeneration) {
+            break;
+        }
+        vector<int> finalWCTs;
+        for (RunResult & run : runResults) {
+            finalWCTs.push_back(run.bestWCT);
+        }
+        sort(finalWCTs.begin(),finalWCTs.end());
+        int target = finalWCTs[finalWCTs.size()/2];
+
+        /// experiment runner, strong then weak scaling
+        record.path = "runs";
+        const char * modes[2] = {"strong", "weak"};
+        for (int m = 0; m < 2 && cancelGeneration.load() == scalingGeneration; m++) {
+            record.mode = modes[m];
+            for (int t : threadCounts) {
+                int nbRuns = m == 0 ? runsPerThread * maxThreads : runsPerThread * t;
+                vector<int> runIndices = allRuns(nbRuns);
+                auto start = chrono::steady_clock::now();
+                if (!executeRuns(instanceNames[i],target,false,timeLimit,nbRuns,runIndices,t,1,runTimes,runResults,targetTimes)) {
+                    return false;
+                }
+                if (cancelGeneration.load() != scalingGeneration) { /// the batch was cut short, its measure is meaningless
+                    break;
+                }
+                double wallTime = chrono::duration<double, std::milli>(chrono::steady_clock::now() - start).count();
+                double evaluations = 0.;
+                record.timeToTarget = -1.;
+                for (int run = 0; run < nbRuns; run++) {
+                    evaluations += runResults[run].evaluations;
+                    if (targetTimes[run] >= 0 && (record.timeToTarget < 0 || targetTimes[run] < record.timeToTarget)) {
+                        record.timeToTarget = targetTimes[run];
+                    }
+                }
+                if (t == 1) {
+                    sequentialTime = wallTime;
+                }
+                record.nbThreads = t;
+                record.nbRuns = nbRuns;
+                record.wallTime = wallTime;
+                if (m == 0) {
+                    record.speedup = sequentialTime / wallTime;
+                    record.efficiency = record.speedup / t;
+                } else {
+                    record.efficiency = sequentialTime / wallTime;
+                    record.speedup = record.efficiency * t;
+                }
+                record.evaluationsPerSecond = evaluations / (wallTime / 1000.);
+                printScalingRecord(record);
+                records.push_back(record);
+            }
+        }
+        if (cancelGeneration.load() != scalingGeneration) {
+            cout << "interrupted, the measures so far are written" << endl;
+            break;
+        }
+    }
+
+    if (!writeScalingJSON(scaling_output,records)) {
+        return false;
+    }
+    cout << "written to " << scaling_output << endl;
+    return true;
+}
+
+#endif
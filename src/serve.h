@@ -0,0 +1,981 @@
+/*****************************************************************************
+ * Solver daemon : JSONL requests on a Unix socket or the standard input,   *
+ * solved by a pool of warm workers                                          *
+ *****************************************************************************/
+
+#ifndef _SERVE_H_
+#define _SERVE_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <climits>
+#include <csignal>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "files.h"
+#include "lowerBound.h"
+#include "results.h"
+#include "trace.h"
+#include "store.h"
+#include "aco.h"
+#include "ils.h"
+#include "ig.h"
+
+using namespace std;
+
+/// period of the readers and of the accept loop checking for the stop of the daemon, ms
+#define SERVE_POLL_MS 200
+/// minimal delay between two progress events of a request, ms
+#define SERVE_PROGRESS_MS 100
+/// instances read on demand kept in memory, the least recently used one is dropped beyond (the preloaded ones always stay)
+#define SERVE_CACHE_ENTRIES 256
+
+/// A client of the daemon : the requests are read from it, the responses written to it (one JSON object per line)
+struct ServeConnection {
+    int descriptor; /// closed with the last reference, once its reader and its requests are done
+    mutex writeMutex;
+    bool broken = false; /// the client went away, its responses are dropped
+
+    ServeConnection(int descriptor) : descriptor(descriptor) {}
+    ~ServeConnection() { close(descriptor); }
+};
+
+/**
+ * One request, one line of JSON :
+ *      {"id":"r1", "instance":"instances/50_20_01", "sls":"ILS", "time_limit":2000, "max_evaluations":100000,
+ *       "seed":7, "target":0, "max_iterations":100, "lambda":4, "progress":true}
+ * instance is a path or the name of a preloaded instance; "instance_data" gives the text of the instance instead.
+ * The parameters of the heuristics (rho, max_iterations, nbPerturbationSteps, lambda, nbDestructions) are optional.
+ * A line which is not one valid JSON object, or with an unknown field or a field of the wrong type, is answered with an error.
+ */
+struct ServeRequest {
+    string id; /// echoed in the responses, as a string
+    string instanceName; /// "inline" with instanceData
+    string instanceData; /// text of the instance, empty to read instanceName
+    SLS sls = ILS;
+    double timeLimit = 250*1000.; /// ms
+    double maxEvaluations = 0.;
+    unsigned int runSeed = 1;
+    int target = 0; /// the run stops once it reaches it, 0 for none
+    HeuristicParameters parameters;
+    bool progress = false; /// stream the improvements
+    bool cacheInstance = true; /// the instance is kept in memory for the next requests (not for a batch, see runBatch)
+    shared_ptr<ServeConnection> connection;
+};
+
+/// An instance kept in memory by the daemon, read again once its file changes
+struct CachedInstance {
+    PfspInstance instance;
+    long long lowerBound;
+    string fileName;
+    struct stat fileStat; /// size and modification time of the file when it was read
+    bool preloaded = false;
+    unsigned long long lastUse = 0; /// value of instanceCacheClock at the last request
+};
+
+deque<ServeRequest> serveRequests; /// requests waiting for a worker, at most serve_queue
+mutex serveMutex;
+condition_variable serveNotEmpty;
+condition_variable serveNotFull;
+bool serveClosed = false; /// no more requests, the workers end once the queue is empty
+int serveGeneration = 0; /// value of cancelGeneration when the daemon started, a signal stops it
+atomic<int> activeReaders (0);
+atomic<int> serveErrors (0); /// requests answered with an error
+
+map<string, shared_ptr<CachedInstance>> instanceCache; /// by path, and by name for the preloaded instances
+mutex instanceCacheMutex;
+unsigned long long instanceCacheClock = 0; /// number of lookups in the cache, orders its entries by last use
+
+/**
+ * Test if the daemon was asked to stop (SIGINT, SIGTERM) : the running solves end with their best solution,
+ * the queued ones are answered with an error
+ */
+bool serveStopped()
+{
+    return cancelGeneration.load() != serveGeneration;
+}
+
+/**
+ * Read the name of a heuristic
+ *
+ * @param[in] name ACO, ILS or IG
+ * @param[out] sls The heuristic
+ * @return false if the name is unknown, true otherwise
+ */
+bool parseSLSName(string name, SLS & sls)
+{
+    if (name == "ACO") {
+        sls = ACO;
+    } else if (name == "ILS") {
+        sls = ILS;
+    } else if (name == "IG") {
+        sls = IG;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Write a response to a client, whole : the workers and the reader of a connection share it
+ *
+ * @param[in] connection The client
+ * @param[in] response One JSON object, end of line included
+ */
+void sendResponse(shared_ptr<ServeConnection> & connection, string response)
+{
+    lock_guard<mutex> lock(connection->writeMutex);
+    size_t written = 0;
+    while (!connection->broken && written < response.size()) {
+        ssize_t count = write(connection->descriptor, response.data() + written, response.size() - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            connection->broken = true;
+        } else {
+            written += count;
+        }
+    }
+}
+
+/**
+ * Beginning of a response, without the closing brace
+ */
+string responseHead(string id, string event)
+{
+    return "{\"id\":\"" + jsonEscape(id) + "\",\"event\":\"" + event + "\"";
+}
+
+string errorResponse(string id, string message)
+{
+    return responseHead(id,"error") + ",\"message\":\"" + jsonEscape(message) + "\"}\n";
+}
+
+/// parameters of the heuristics a request (or the command line of a batch) can set
+const char * overridableParameters[5] = {"rho", "max_iterations", "nbPerturbationSteps", "lambda", "nbDestructions"};
+
+/**
+ * Test if a command line argument of a batch is one of overridableParameters (--name)
+ */
+bool isOverridableParameter(string argument)
+{
+    for (const char * name : overridableParameters) {
+        if (argument == string("--") + name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Set a parameter of the heuristics for the requests, after its range check (see checkParameter)
+ *
+ * @param[in] name One of overridableParameters
+ * @param[in] value Its value
+ * @param[in,out] parameters The parameters of the request
+ * @param[out] message Why the value is out of range
+ * @return false if the value is out of range, true otherwise
+ */
+bool setParameterOverride(string name, string value, HeuristicParameters & parameters, string & message)
+{
+    double number = atof(value.c_str());
+    if (!checkParameter(name,number,message)) {
+        return false;
+    }
+    if (name == "rho") {
+        parameters.rho = number;
+    } else if (name == "max_iterations") {
+        parameters.max_iterations = (int)number;
+    } else if (name == "nbPerturbationSteps") {
+        parameters.nbPerturbationSteps = (int)number;
+    } else if (name == "lambda") {
+        parameters.lambda = number;
+    } else {
+        parameters.nbDestructions = (int)number;
+    }
+    return true;
+}
+
+/// fields of a request and their JSON type ('s'tring, 'n'umber, 'b'oolean; the id is a string or a number)
+const pair<const char *, char> requestFields[] = {{"id", 's'}, {"instance", 's'}, {"instance_data", 's'}, {"sls", 's'},
+    {"time_limit", 'n'}, {"max_evaluations", 'n'}, {"seed", 'n'}, {"target", 'n'}, {"progress", 'b'}, {"rho", 'n'},
+    {"max_iterations", 'n'}, {"nbPerturbationSteps", 'n'}, {"lambda", 'n'}, {"nbDestructions", 'n'}};
+
+/**
+ * Read a request : one JSON object, whose fields are all known and of their type
+ *
+ * @param[in] line One line sent by a client
+ * @param[in] defaults Values of the fields missing from the request (command line of the daemon)
+ * @param[out] request The request
+ * @param[out] message Why the request is invalid
+ * @return false if the request is invalid, true otherwise
+ */
+bool parseRequest(string & line, ServeRequest & defaults, ServeRequest & request, string & message)
+{
+    request = defaults;
+    map<string, JSONValue> fields;
+    if (!parseJSONObject(line,fields,message)) {
+        return false;
+    }
+    if (fields.count("id") && (fields["id"].type == 's' || fields["id"].type == 'n')) {
+        request.id = fields["id"].text;
+    }
+    for (auto & field : fields) {
+        const pair<const char *, char> * known = NULL;
+        for (auto & requestField : requestFields) {
+            if (field.first == requestField.first) {
+                known = &requestField;
+            }
+        }
+        if (known == NULL) {
+            message = "unknown field " + field.first;
+            return false;
+        }
+        if (field.second.type != known->second && !(field.first == "id" && field.second.type == 'n')) {
+            message = field.first + (known->second == 's' ? " should be a string" : known->second == 'n' ? " should be a number" : " should be true or false");
+            return false;
+        }
+    }
+
+    if (fields.count("instance_data")) {
+        request.instanceName = "inline";
+        request.instanceData = fields["instance_data"].text;
+    } else if (fields.count("instance") && !fields["instance"].text.empty() && fields["instance"].text != "-") {
+        request.instanceName = fields["instance"].text;
+    } else {
+        message = "the request needs an instance (path or name) or its instance_data";
+        return false;
+    }
+    if (fields.count("sls") && !parseSLSName(fields["sls"].text,request.sls)) {
+        message = "sls should be ACO, ILS or IG";
+        return false;
+    }
+    if (fields.count("time_limit")) {
+        request.timeLimit = atof(fields["time_limit"].text.c_str());
+    }
+    if (fields.count("max_evaluations")) {
+        request.maxEvaluations = atof(fields["max_evaluations"].text.c_str());
+    }
+    if (fields.count("seed")) {
+        double number = atof(fields["seed"].text.c_str());
+        if (number < 0 || number > UINT_MAX || number != floor(number)) {
+            message = "seed should be an integer in [0, 2^32-1]";
+            return false;
+        }
+        request.runSeed = (unsigned int)number;
+    }
+    if (fields.count("target")) {
+        double number = atof(fields["target"].text.c_str());
+        if (number < INT_MIN || number > INT_MAX || number != floor(number)) {
+            message = "target should be an integer";
+            return false;
+        }
+        request.target = (int)number;
+    }
+    for (const char * name : overridableParameters) {
+        if (fields.count(name) && !setParameterOverride(name,fields[name].text,request.parameters,message)) {
+            return false;
+        }
+    }
+    if (fields.count("progress")) {
+        request.progress = fields["progress"].text == "true";
+    }
+    if (request.timeLimit <= 0) {
+        message = "time_limit should be positive";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Queue a request, blocks while serve_queue requests are waiting (the client is not read meanwhile)
+ *
+ * @param[in] request The request
+ * @return false if the daemon is stopping, true otherwise
+ */
+bool pushRequest(ServeRequest & request)
+{
+    unique_lock<mutex> lock(serveMutex);
+    while ((int)serveRequests.size() >= serve_queue && !serveClosed && !serveStopped()) {
+        serveNotFull.wait_for(lock, chrono::milliseconds(SERVE_POLL_MS));
+    }
+    if (serveClosed || serveStopped()) {
+        return false;
+    }
+    serveRequests.push_back(request);
+    serveNotEmpty.notify_one();
+    return true;
+}
+
+/**
+ * Take the oldest request, blocks while the queue is empty
+ *
+ * @param[out] request The request
+ * @return false if the queue is closed and empty, true otherwise
+ */
+bool popRequest(ServeRequest & request)
+{
+    unique_lock<mutex> lock(serveMutex);
+    serveNotEmpty.wait(lock, [] { return !serveRequests.empty() || serveClosed; });
+    if (serveRequests.empty()) {
+        return false;
+    }
+    request = move(serveRequests.front());
+    serveRequests.pop_front();
+    serveNotFull.notify_one();
+    return true;
+}
+
+void closeQueue()
+{
+    lock_guard<mutex> lock(serveMutex);
+    serveClosed = true;
+    serveNotEmpty.notify_all();
+    serveNotFull.notify_all();
+}
+
+/**
+ * Test if the file of a cached instance is still the one that was read : same size and modification time (ns),
+ * as the sidecar cache (see readInstanceCached)
+ */
+bool cachedInstanceFresh(CachedInstance & cached)
+{
+    struct stat fileStat;
+    return stat(cached.fileName.c_str(),&fileStat) == 0 && fileStat.st_size == cached.fileStat.st_size
+           && fileStat.st_mtim.tv_sec == cached.fileStat.st_mtim.tv_sec && fileStat.st_mtim.tv_nsec == cached.fileStat.st_mtim.tv_nsec;
+}
+
+/**
+ * Instance of the cache, read (text, binary or sidecar cache, see readInstanceCached) and bounded the first time it is asked for,
+ * and again once its file changed. Beyond SERVE_CACHE_ENTRIES instances read on demand, the least recently used one is dropped.
+ *
+ * @param[in] name Path of the instance, or name of a preloaded one
+ * @param[out] cached The instance and its lower bound
+ * @return false if one error occured, true otherwise
+ */
+bool findInstance(string name, shared_ptr<CachedInstance> & cached)
+{
+    shared_ptr<CachedInstance> stale;
+    string fileName = name;
+    {
+        lock_guard<mutex> lock(instanceCacheMutex);
+        auto found = instanceCache.find(name);
+        if (found != instanceCache.end()) {
+            if (cachedInstanceFresh(*found->second)) {
+                cached = found->second;
+                cached->lastUse = ++instanceCacheClock;
+                return true;
+            }
+            stale = found->second;
+            fileName = stale->fileName;
+        }
+    }
+
+    cached = make_shared<CachedInstance>();
+    cached->fileName = fileName;
+    if (stat(fileName.c_str(),&cached->fileStat) != 0) { /// taken before the read : a change during the read is seen next time
+        generateError("serve.h","findInstance","impossible to read the instance","file_name",fileName);
+        return false;
+    }
+    if (!readInstanceCached(fileName) || !checkObjectiveRange(fileName) || !computeLowerBound(lb_threads)) {
+        return false;
+    }
+    cached->instance = instance;
+    cached->lowerBound = lowerBound;
+    cached->preloaded = stale != nullptr && stale->preloaded;
+
+    lock_guard<mutex> lock(instanceCacheMutex);
+    cached->lastUse = ++instanceCacheClock;
+    if (stale != nullptr) { /// the path and the name of a preloaded instance share the entry
+        for (auto & entry : instanceCache) {
+            if (entry.second == stale) {
+                entry.second = cached;
+            }
+        }
+    } else {
+        instanceCache[name] = cached;
+    }
+
+    int nbOnDemand = 0;
+    auto oldest = instanceCache.end();
+    for (auto entry = instanceCache.begin(); entry != instanceCache.end(); ++entry) {
+        if (entry->second->preloaded) {
+            continue;
+        }
+        nbOnDemand ++;
+        if (oldest == instanceCache.end() || entry->second->lastUse < oldest->second->lastUse) {
+            oldest = entry;
+        }
+    }
+    if (nbOnDemand > SERVE_CACHE_ENTRIES) {
+        instanceCache.erase(oldest);
+    }
+    return true;
+}
+
+/**
+ * Read the instances matching a pattern into the cache, known by their path and by their name
+ *
+ * @param[in] pattern Directory or glob pattern of the instances
+ * @return false if one error occured, true otherwise
+ */
+bool preloadInstances(string pattern)
+{
+    vector<string> fileNames;
+    vector<string> instanceNames;
+    int nbFiles = 0;
+    if (!fillFileNames(pattern,fileNames,instanceNames,nbFiles)) {
+        return false;
+    }
+    for (int i = 0; i < nbFiles; i++) {
+        shared_ptr<CachedInstance> cached;
+        if (!findInstance(fileNames[i],cached)) {
+            return false;
+        }
+        lock_guard<mutex> lock(instanceCacheMutex);
+        cached->preloaded = true;
+        instanceCache[instanceNames[i]] = cached;
+    }
+    return true;
+}
+
+/**
+ * Solve a request on the calling thread : its instance is copied into the thread's instance (whose buffers are reused
+ * from one request to the next), the heuristic runs with the parameters of the request, and its improvements are
+ * streamed to the client if asked, at most one every SERVE_PROGRESS_MS
+ *
+ * @param[in] request The request
+ * @param[out] message Why the solve failed
+ * @return false if one error occured, true otherwise (the result is in lastRun)
+ */
+bool solveRequest(ServeRequest & request, string & message)
+{
+    if (!request.instanceData.empty()) {
+        if (!instance.readDataFromText(request.instanceData,request.instanceName) || !checkObjectiveRange(request.instanceName)
+            || !computeLowerBound(lb_threads)) {
+            message = "invalid instance_data";
+            return false;
+        }
+    } else if (!request.cacheInstance) {
+        if (!readInstanceCached(request.instanceName) || !checkObjectiveRange(request.instanceName) || !computeLowerBound(lb_threads)) {
+            message = "impossible to read the instance " + request.instanceName;
+            return false;
+        }
+    } else {
+        shared_ptr<CachedInstance> cached;
+        if (!findInstance(request.instanceName,cached)) {
+            message = "impossible to read the instance " + request.instanceName;
+            return false;
+        }
+        instance = cached->instance;
+        lowerBound = cached->lowerBound;
+    }
+
+    sls_global = request.sls;
+    max_evaluations = request.maxEvaluations;
+    parameterOverrides = request.parameters;
+    seed = request.runSeed;
+    seedRandom(seed);
+
+    auto lastProgress = chrono::steady_clock::now() - chrono::milliseconds(SERVE_PROGRESS_MS);
+    if (request.progress) {
+        improvementListener = [&](const TraceEvent & event) {
+            auto now = chrono::steady_clock::now();
+            if (now - lastProgress < chrono::milliseconds(SERVE_PROGRESS_MS)) {
+                return;
+            }
+            lastProgress = now;
+            ostringstream progress;
+            progress << responseHead(request.id,"progress") << ",\"time_ms\":" << event.time << ",\"evaluations\":" << event.evaluations
+                     << ",\"iteration\":" << event.iteration << ",\"wct\":" << event.wct << "}\n";
+            sendResponse(request.connection,progress.str());
+        };
+    }
+
+    bool readParams = false;
+    bool ok;
+    if (sls_global == ACO) {
+        ok = ACO_heuristic(readParams,request.target,request.timeLimit);
+    } else if (sls_global == ILS) {
+        ok = ILS_heuristic(readParams,request.target,request.timeLimit);
+    } else {
+        ok = IG_heuristic(readParams,request.target,request.timeLimit);
+    }
+    improvementListener = nullptr;
+    parameterOverrides = HeuristicParameters();
+    if (!ok) {
+        message = "the heuristic failed";
+    }
+    return ok;
+}
+
+/**
+ * Body of a worker : solve the queued requests until the queue is closed
+ * The result is sent as the record of the results file (see formatResult) with the id, the event and the lower bound;
+ * it also goes to the results file (--results) and to the store (--store) if given.
+ */
+void serveWorker()
+{
+    ServeRequest request;
+    while (popRequest(request)) {
+        string message;
+        if (serveStopped()) {
+            serveErrors ++;
+            sendResponse(request.connection,errorResponse(request.id,"cancelled, the daemon is stopping"));
+        } else if (!solveRequest(request,message)) {
+            serveErrors ++;
+            sendResponse(request.connection,errorResponse(request.id,message));
+        } else {
+            bool improved = false;
+            if (!store_directory.empty()) {
+                storeUpdate(lastRun.bestSol,lastRun.bestWCT,improved);
+            }
+            if (!results_file.empty()) {
+                pushResult(request.instanceName,lastRun);
+            }
+            ResultRecord record;
+            record.instance = request.instanceName;
+            ostringstream algorithm;
+            algorithm << sls_global;
+            record.algorithm = algorithm.str();
+            record.seed = seed;
+            record.run = lastRun;
+            ostringstream result;
+            result << responseHead(request.id,"result") << ",\"lower_bound\":" << lowerBound << ",\"new_best_known\":"
+                   << (improved ? "true" : "false") << "," << formatResult(record,true).substr(1);
+            sendResponse(request.connection,result.str());
+        }
+        request = ServeRequest(); /// the connection is released
+    }
+}
+
+/**
+ * Read one line of a client and queue its request, or answer it with an error
+ *
+ * @param[in] connection The client, where the responses go
+ * @param[in] line The line, without its end
+ * @param[in] defaults Values of the fields missing from the request
+ */
+void queueRequestLine(shared_ptr<ServeConnection> & connection, string & line, ServeRequest & defaults)
+{
+    if (line.find_first_not_of(" \t\r") == string::npos) {
+        return;
+    }
+    ServeRequest request;
+    string message;
+    if (!parseRequest(line,defaults,request,message)) {
+        sendResponse(connection,errorResponse(request.id,message));
+        return;
+    }
+    request.connection = connection;
+    if (!pushRequest(request)) {
+        sendResponse(connection,errorResponse(request.id,"cancelled, the daemon is stopping"));
+    }
+}
+
+/**
+ * Body of a reader : split the input of a client into requests and queue them, until its end or the stop of the daemon
+ * The last request may lack its line end.
+ *
+ * @param[in] connection The client, where the responses go
+ * @param[in] inputDescriptor Where the requests come from
+ * @param[in] defaults Values of the fields missing from the requests
+ */
+void readRequests(shared_ptr<ServeConnection> connection, int inputDescriptor, ServeRequest & defaults)
+{
+    string pending;
+    char chunk[1 << 16];
+    while (!serveStopped()) {
+        pollfd descriptor = {inputDescriptor, POLLIN, 0};
+        int ready = poll(&descriptor, 1, SERVE_POLL_MS);
+        if (ready == 0 || (ready < 0 && errno == EINTR)) {
+            continue;
+        }
+        ssize_t count = ready < 0 ? -1 : read(inputDescriptor, chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count == 0) { /// end of the input : the last line may have no line end
+            queueRequestLine(connection,pending,defaults);
+            break;
+        }
+        if (count < 0) {
+            break;
+        }
+        pending.append(chunk, count);
+        size_t lineEnd;
+        while ((lineEnd = pending.find('\n')) != string::npos) {
+            string line = pending.substr(0, lineEnd);
+            pending.erase(0, lineEnd + 1);
+            queueRequestLine(connection,line,defaults);
+        }
+    }
+}
+
+/**
+ * Complete the defaults of the requests with the common arguments, and check them (daemon and batch)
+ *
+ * @param[in,out] defaults Values of the fields missing from the requests
+ * @return false if one error occured, true otherwise
+ */
+bool checkServeArguments(ServeRequest & defaults)
+{
+    defaults.maxEvaluations = max_evaluations;
+    defaults.runSeed = seed;
+
+    if (instance_file != NULL || !checkpoint_file.empty() || !edits_file.empty() || !initial_solution_file.empty() || !trace_file.empty()) {
+        generateError("serve.h","checkServeArguments","the instances come with the requests, --instance_file, --checkpoint, --edits, --initial_solution and --trace are not supported");
+        return false;
+    }
+    if (serve_workers <= 0 || serve_queue <= 0) {
+        generateError("serve.h","checkServeArguments","workers and queue should be positive");
+        return false;
+    }
+    if (defaults.timeLimit <= 0) {
+        generateError("serve.h","checkServeArguments","time_limit should be positive","time_limit",defaults.timeLimit);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Start the workers solving the queued requests, and the writer of the results file if any
+ *
+ * @param[out] workers The threads
+ * @return false if one error occured, true otherwise
+ */
+bool startWorkers(vector<thread> & workers)
+{
+    serveGeneration = cancelGeneration.load();
+    signal(SIGPIPE, SIG_IGN); /// a client that went away is detected by write
+    if (!results_file.empty() && !startResultsWriter(results_file)) {
+        return false;
+    }
+    for (int w = 0; w < serve_workers; w++) {
+        workers.push_back(thread(serveWorker));
+    }
+    return true;
+}
+
+/**
+ * Close the queue and wait for the workers to answer the requests left, then for the readers to end
+ *
+ * @param[in] workers The threads
+ */
+void stopWorkers(vector<thread> & workers)
+{
+    closeQueue();
+    for (thread & worker : workers) {
+        worker.join();
+    }
+    while (activeReaders > 0) {
+        this_thread::sleep_for(chrono::milliseconds(SERVE_POLL_MS / 4));
+    }
+    stopResultsWriter();
+}
+
+/**
+ * The responses go to the standard output, the console output (errors, reports) is sent to the standard error
+ * so it can't mix with them
+ *
+ * @return the standard output
+ */
+shared_ptr<ServeConnection> standardOutputConnection()
+{
+    cout.flush();
+    int responseDescriptor = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    return make_shared<ServeConnection>(responseDescriptor);
+}
+
+/**
+ * Read the arguments of the daemon, after --serve <socket path or -> :
+ *      --workers <n>, --queue <n>, --preload <directory or glob>, and the defaults of the requests :
+ *      --SLS <ACO, ILS or IG>, --time_limit <ms>, --max_evaluations <units>, --seed <s>
+ * The common arguments of the runs apply to every request (--cpu_time, --gap, --lb_threads, --no_cache, --store, --results, ...).
+ *
+ * @param[out] defaults Values of the fields missing from the requests
+ * @param[out] preloadPattern Instances read at startup, empty for none
+ * @return false if one error occured, true otherwise
+ */
+bool readServeArguments(ServeRequest & defaults, string & preloadPattern)
+{
+    preloadPattern = "";
+    for (int i = 3; i < argc_global; i++) {
+        if (argv_global[i] == "--SLS" && i+1 < argc_global) {
+            if (!parseSLSName(argv_global[i+1],defaults.sls)) {
+                generateError("serve.h","readServeArguments","SLS parameter not recognized","sls",argv_global[i+1]);
+                return false;
+            }
+            i++;
+        } else if (argv_global[i] == "--workers" && i+1 < argc_global) {
+            serve_workers = stoi(argv_global[i+1]);
+            i++;
+        } else if (argv_global[i] == "--queue" && i+1 < argc_global) {
+            serve_queue = stoi(argv_global[i+1]);
+            i++;
+        } else if (argv_global[i] == "--preload" && i+1 < argc_global) {
+            preloadPattern = argv_global[i+1];
+            i++;
+        } else if (argv_global[i] == "--time_limit" && i+1 < argc_global) {
+            defaults.timeLimit = stod(argv_global[i+1]);
+            i++;
+        } else if (!readCommonArgument(i)) {
+            generateError("serve.h","readServeArguments","Parameter not recognised","Parameter",argv_global[i]);
+            return false;
+        }
+    }
+    return checkServeArguments(defaults);
+}
+
+/**
+ * Accept the clients of a Unix domain socket, one reader thread each, until the daemon is stopped
+ *
+ * @param[in] path Path of the socket, replaced if it is a socket (left by a previous daemon), removed at the end;
+ *                 any other existing file is refused
+ * @param[in] defaults Values of the fields missing from the requests
+ * @return false if one error occured, true otherwise
+ */
+bool acceptClients(string path, ServeRequest & defaults)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        generateError("serve.h","acceptClients","socket path too long","socket",path);
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+    struct stat pathStat;
+    if (lstat(path.c_str(),&pathStat) == 0) {
+        if (!S_ISSOCK(pathStat.st_mode)) {
+            generateError("serve.h","acceptClients","the path exists and is not a socket","socket",path);
+            return false;
+        }
+        unlink(path.c_str());
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, (sockaddr *)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+        generateError("serve.h","acceptClients","impossible to listen on the socket","socket",path);
+        if (listener >= 0) {
+            close(listener);
+        }
+        return false;
+    }
+
+    while (!serveStopped()) {
+        pollfd descriptor = {listener, POLLIN, 0};
+        if (poll(&descriptor, 1, SERVE_POLL_MS) <= 0) {
+            continue;
+        }
+        int client = accept(listener, NULL, NULL);
+        if (client < 0) {
+            continue;
+        }
+        activeReaders ++;
+        thread([client, &defaults]() {
+            readRequests(make_shared<ServeConnection>(client),client,defaults);
+            activeReaders --;
+        }).detach();
+    }
+    close(listener);
+    if (lstat(path.c_str(),&pathStat) == 0 && S_ISSOCK(pathStat.st_mode)) {
+        unlink(path.c_str());
+    }
+    return true;
+}
+
+/**
+ * Solver daemon mode : ./main --serve <socket path or -> [arguments, see readServeArguments]
+ *
+ * The requests (see ServeRequest) are read from the clients of the Unix domain socket, or from the standard input with -,
+ * and queued (at most serve_queue, the readers wait beyond); serve_workers threads solve them, each one keeping its
+ * instance buffers from one request to the next, the instances being read once and kept in memory. Each request gets
+ * "progress" events if asked, then one "result" or "error" event, on the connection it came from (on the standard output with -).
+ * With the standard input, the daemon ends once every request is answered after the end of the input; a SIGINT or
+ * SIGTERM stops it (socket or standard input) : the running solves return their best solution, the queued ones are cancelled.
+ *
+ * @return false if one error occured, true otherwise
+ */
+bool runServe()
+{
+    string address = argv_global[2];
+    ServeRequest defaults;
+    string preloadPattern;
+    if (!readServeArguments(defaults,preloadPattern)) {
+        help();
+        return false;
+    }
+    bool verbose = !quiet;
+    quiet = true;
+
+    if (!preloadPattern.empty() && !preloadInstances(preloadPattern)) {
+        return false;
+    }
+    vector<thread> workers;
+    if (!startWorkers(workers)) {
+        return false;
+    }
+
+    bool ok = true;
+    if (address == "-") {
+        if (verbose) {
+            cerr << "solver daemon on the standard input, " << serve_workers << " worker(s), " << instanceCache.size() << " instance name(s) preloaded" << endl;
+        }
+        readRequests(standardOutputConnection(),STDIN_FILENO,defaults);
+    } else {
+        if (verbose) {
+            cout << "solver daemon on " << address << ", " << serve_workers << " worker(s), " << instanceCache.size() << " instance name(s) preloaded" << endl;
+        }
+        ok = acceptClients(address,defaults);
+    }
+
+    stopWorkers(workers);
+    return ok;
+}
+
+/**
+ * Read the list of the instances of a batch : one path, directory or glob pattern per line (see fillFileNames),
+ * the empty lines and the lines starting with # are ignored. A path is kept even if the file is missing,
+ * the batch reports it in its record.
+ *
+ * @param[in] listName Name of the list, - for the standard input
+ * @param[out] fileNames Names of the instances files, in the order of the list
+ * @return false if one error occured, true otherwise
+ */
+bool readBatchList(string listName, vector<string> & fileNames)
+{
+    ifstream listFile;
+    if (listName != "-") {
+        listFile.open(listName);
+        if (!listFile) {
+            generateError("serve.h","readBatchList","impossible to open a file","file_name",listName);
+            return false;
+        }
+    }
+    istream & listStream = listName == "-" ? cin : listFile;
+    fileNames.clear();
+    string line;
+    while (getline(listStream, line)) {
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == string::npos || line[begin] == '#') {
+            continue;
+        }
+        line = line.substr(begin, line.find_last_not_of(" \t\r") - begin + 1);
+        struct stat lineStat;
+        bool directory = stat(line.c_str(),&lineStat) == 0 && S_ISDIR(lineStat.st_mode);
+        if (!directory && line.find_first_of("*?[") == string::npos) {
+            fileNames.push_back(line);
+            continue;
+        }
+        vector<string> matches;
+        vector<string> instanceNames;
+        int nbFiles;
+        if (!fillFileNames(line,matches,instanceNames,nbFiles)) {
+            return false;
+        }
+        fileNames.insert(fileNames.end(), matches.begin(), matches.end());
+    }
+    return true;
+}
+
+/**
+ * Batch mode : ./main --SLS <ACO, ILS or IG> --batch <list|-> [--threads <n>] [--time_limit <ms>] [--max_evaluations <units>]
+ *      [--seed <s>] [parameters of the heuristic] [common arguments, see readCommonArgument]
+ *
+ * Each instance of the list (see readBatchList) is solved once, with the same heuristic, parameters, budget and seed,
+ * in one process : the requests go through the queue of the daemon to --threads workers (1 by default), which reuse
+ * their buffers from one instance to the next. One record per instance is written on the standard output, in the
+ * order of completion : the result (its "id" is the position of the instance in the list, from 1) or the error;
+ * --results writes the results in a CSV or JSONL file as well. A SIGINT or SIGTERM stops the batch.
+ *
+ * @return false if one error occured or one instance failed, true otherwise
+ */
+bool runBatch()
+{
+    string listName = "";
+    ServeRequest defaults;
+    defaults.sls = sls_global;
+    defaults.cacheInstance = false;
+    for (int i = 3; i < argc_global; i++) {
+        if (argv_global[i] == "--batch" && i+1 < argc_global) {
+            listName = argv_global[i+1];
+            i++;
+        } else if (argv_global[i] == "--threads" && i+1 < argc_global) {
+            serve_workers = stoi(argv_global[i+1]);
+            i++;
+        } else if (argv_global[i] == "--time_limit" && i+1 < argc_global) {
+            defaults.timeLimit = stod(argv_global[i+1]);
+            i++;
+        } else if (isOverridableParameter(argv_global[i]) && i+1 < argc_global) {
+            string message;
+            if (!setParameterOverride(argv_global[i].substr(2),argv_global[i+1],defaults.parameters,message)) {
+                generateError("serve.h","runBatch",message);
+                return false;
+            }
+            i++;
+        } else if (!readCommonArgument(i)) {
+            generateError("serve.h","runBatch","Parameter not recognised","Parameter",argv_global[i]);
+            help();
+            return false;
+        }
+    }
+    if (!checkServeArguments(defaults)) {
+        return false;
+    }
+    vector<string> fileNames;
+    if (!readBatchList(listName,fileNames)) {
+        return false;
+    }
+
+    bool verbose = !quiet;
+    quiet = true;
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    if (!startWorkers(workers)) {
+        return false;
+    }
+    shared_ptr<ServeConnection> output = standardOutputConnection();
+    int nbQueued = 0;
+    for (size_t i = 0; i < fileNames.size(); i++) {
+        ServeRequest request = defaults;
+        request.id = to_string(i + 1);
+        request.instanceName = fileNames[i];
+        request.connection = output;
+        if (!pushRequest(request)) {
+            break;
+        }
+        nbQueued ++;
+    }
+    output.reset();
+    stopWorkers(workers);
+
+    if (verbose) {
+        cerr << "batch : " << nbQueued << " of " << fileNames.size() << " instance(s) solved or tried, " << serveErrors << " error(s), "
+             << chrono::duration<double>(chrono::steady_clock::now() - start).count() << "s on " << serve_workers << " thread(s)" << endl;
+    }
+    return serveErrors == 0 && nbQueued == (int)fileNames.size();
+}
+
+#endif
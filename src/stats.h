@@ -0,0 +1,135 @@
+/****************************************************************************
+ * Solver counters (compiled in with make STATS=1) and statistics report    *
+ ****************************************************************************/
+
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <iostream>
+#include <sys/resource.h>
+
+#include "globalVariables.h"
+
+using namespace std;
+
+/// The counters cost nothing unless the program is compiled with -DSTATS
+#ifdef STATS
+#define STAT_INC(counter) (solverStats.counter++)
+#define STAT_ADD(counter, value) (solverStats.counter += (value))
+#else
+#define STAT_INC(counter) ((void)0)
+#define STAT_ADD(counter, value) ((void)0)
+#endif
+
+struct SolverStats {
+    long long fullEvaluations;
+    long long partialEvaluations;
+    long long insertionScans; /// accelerated evaluations of all the insertion positions (see objective.h)
+    long long movesEvaluated[3]; /// indexed by Neighborhood
+    long long movesAccepted[3];
+    long long vndDescents;
+    long long constructions; /// ACO
+    long long disturbances; /// ACO
+    long long improvingAcceptances; /// ILS and IG
+    long long worseningAcceptances;
+    long long rejections;
+};
+
+thread_local SolverStats solverStats;
+
+/**
+ * Set all the counters to zero, at the beginning of a run
+ */
+void resetStats()
+{
+    solverStats = SolverStats();
+}
+
+/**
+ * Count a call of the evaluation function, full or partial
+ * 
+ * @param[in] nbJobs Number of jobs of the evaluated solution
+ */
+inline void countEvaluation([[maybe_unused]] int nbJobs)
+{
+#ifdef STATS
+    if (nbJobs == instance.getNbJob()) {
+        solverStats.fullEvaluations ++;
+    } else {
+        solverStats.partialEvaluations ++;
+    }
+#endif
+}
+
+/**
+ * Peak resident memory of the process
+ * 
+ * @return the peak memory in KB
+ */
+long peakMemoryKB()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_maxrss;
+}
+
+/**
+ * Print the statistics of the run that just ended, as a summary (stats_format text) or one JSON line (json)
+ * 
+ * The headline is the throughput in evaluations (work units, see budget.h) per second, always available ;
+ * the counters are only printed when compiled in.
+ * 
+ * @param[in] time Duration of the run, ms
+ */
+void printStats(double time)
+{
+    double evaluations = instance.getNbEvaluations();
+    double evaluationsPerSecond = time > 0 ? evaluations/(time/1000.) : 0.;
+    [[maybe_unused]] const char * neighborhoods[3] = {"transpose","exchange","insert"};
+
+    if (stats_format == "json") {
+        cout << "{\"algorithm\":\"" << sls_global << "\",\"time_ms\":" << time << ",\"evaluations\":" << evaluations
+             << ",\"evaluations_per_s\":" << evaluationsPerSecond << ",\"peak_memory_kb\":" << peakMemoryKB();
+#ifdef STATS
+        cout << ",\"full_evaluations\":" << solverStats.fullEvaluations
+             << ",\"partial_evaluations\":" << solverStats.partialEvaluations
+             << ",\"insertion_scans\":" << solverStats.insertionScans;
+        for (int n = 0; n < 3; n++) {
+            cout << ",\"" << neighborhoods[n] << "_evaluated\":" << solverStats.movesEvaluated[n]
+                 << ",\"" << neighborhoods[n] << "_accepted\":" << solverStats.movesAccepted[n];
+        }
+        cout << ",\"vnd_descents\":" << solverStats.vndDescents
+             << ",\"constructions\":" << solverStats.constructions
+             << ",\"disturbances\":" << solverStats.disturbances
+             << ",\"improving_acceptances\":" << solverStats.improvingAcceptances
+             << ",\"worsening_acceptances\":" << solverStats.worseningAcceptances
+             << ",\"rejections\":" << solverStats.rejections;
+#endif
+        cout << "}" << endl;
+        return;
+    }
+
+    cout << "Statistics (" << sls_global << "):\n"
+         << "   evaluations per second : " << evaluationsPerSecond << "\n"
+         << "   evaluations : " << evaluations << " in " << time/1000. << "s\n"
+         << "   peak memory : " << peakMemoryKB() << " KB\n";
+#ifdef STATS
+    cout << "   computeWCT calls : " << solverStats.fullEvaluations << " full, " << solverStats.partialEvaluations << " partial, "
+         << solverStats.insertionScans << " insertion scans\n";
+    for (int n = 0; n < 3; n++) {
+        cout << "   " << neighborhoods[n] << " : " << solverStats.movesEvaluated[n] << " moves evaluated, "
+             << solverStats.movesAccepted[n] << " accepted\n";
+    }
+    cout << "   VND descents : " << solverStats.vndDescents << "\n"
+         << "   ACO constructions : " << solverStats.constructions << ", disturbances : " << solverStats.disturbances << "\n"
+         << "   acceptances : " << solverStats.improvingAcceptances << " improving, " << solverStats.worseningAcceptances
+         << " worsening, " << solverStats.rejections << " rejected\n";
+#else
+    cout << "   <counters compiled out, build with make STATS=1>\n";
+#endif
+    cout << endl;
+}
+
+#endif
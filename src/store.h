@@ -0,0 +1,241 @@
+/*****************************************************************************
+ * Persistent store of the best known solutions, keyed by instance content   *
+ *****************************************************************************/
+
+#ifndef _STORE_H_
+#define _STORE_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "objective.h"
+#include "localSearch.h"
+
+using namespace std;
+
+/// One solution of the store
+struct StoredSolution {
+    int wct;
+    vector<int> sol; /// sol[1:nbJob]
+};
+
+/**
+ * File of the global instance in the store : one file per instance content (see PfspInstance::contentHash) and objective,
+ * so an instance is found whatever its file name or format
+ *
+ * @return the name of the file
+ */
+string storeFileName()
+{
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)instance.contentHash());
+    return store_directory + "/" + hash + "_" + Objective::shortName() + ".sol";
+}
+
+/**
+ * Read the solutions of a store file, best first :
+ *      # best known solutions <objective> jobs=<n> machines=<m>
+ *      <value> <job 1> ... <job n>       (one line per solution of the elite set)
+ * The solutions which are not permutations of the jobs of the global instance are ignored.
+ *
+ * @param[in] fileName Name of the file, a missing file is an empty store
+ * @param[out] elite The solutions
+ * @return false if one error occured, true otherwise
+ */
+bool readStore(string fileName, vector<StoredSolution> & elite)
+{
+    elite.clear();
+    ifstream storeStream(fileName);
+    if (!storeStream) {
+        return true;
+    }
+    int nbJobs = instance.getNbJob();
+    string line;
+    while (getline(storeStream, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream fields(line);
+        StoredSolution stored;
+        stored.sol.assign(nbJobs+1, 0);
+        vector<bool> used (nbJobs+1, false);
+        bool valid = (bool)(fields >> stored.wct);
+        for (int j = 1; j <= nbJobs && valid; j++) {
+            valid = (bool)(fields >> stored.sol[j]) && stored.sol[j] >= 1 && stored.sol[j] <= nbJobs && !used[stored.sol[j]];
+            if (valid) {
+                used[stored.sol[j]] = true;
+            }
+        }
+        if (valid) {
+            elite.push_back(stored);
+        }
+    }
+    sort(elite.begin(), elite.end(), [](const StoredSolution & a, const StoredSolution & b) { return a.wct < b.wct; });
+    return true;
+}
+
+/**
+ * Replace a store file, atomically : the solutions are written in a temporary file, synced, then renamed
+ *
+ * @param[in] fileName Name of the file
+ * @param[in] elite The solutions, best first
+ * @return false if one error occured, true otherwise
+ */
+bool writeStore(string fileName, vector<StoredSolution> & elite)
+{
+    ostringstream temporaryName;
+    temporaryName << fileName << ".tmp." << getpid() << "." << this_thread::get_id();
+    FILE * stream = fopen(temporaryName.str().c_str(), "w");
+    if (stream == NULL) {
+        generateError("store.h","writeStore","impossible to open a file","file_name",temporaryName.str());
+        return false;
+    }
+    fprintf(stream, "# best known solutions %s jobs=%d machines=%d\n", Objective::name(), instance.getNbJob(), instance.getNbMac());
+    for (StoredSolution & stored : elite) {
+        fprintf(stream, "%d", stored.wct);
+        for (size_t j = 1; j < stored.sol.size(); j++) {
+            fprintf(stream, " %d", stored.sol[j]);
+        }
+        fprintf(stream, "\n");
+    }
+    bool written = fflush(stream) == 0 && fsync(fileno(stream)) == 0;
+    written = fclose(stream) == 0 && written;
+    if (!written || rename(temporaryName.str().c_str(), fileName.c_str()) != 0) {
+        remove(temporaryName.str().c_str());
+        generateError("store.h","writeStore","impossible to write the store","file_name",fileName);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Best known solution of the global instance, if the store has one
+ * Its value is computed again, the store is not trusted blindly.
+ *
+ * @param[out] sol The solution
+ * @param[out] wct Its value
+ * @param[out] found True if the store had a solution, false otherwise (sol and wct untouched)
+ * @return false if one error occured, true otherwise
+ */
+bool storeLookup(vector<int> & sol, int & wct, bool & found)
+{
+    found = false;
+    vector<StoredSolution> elite;
+    if (!readStore(storeFileName(),elite)) {
+        return false;
+    }
+    if (elite.empty()) {
+        return true;
+    }
+    sol = elite[0].sol;
+    Objective::evaluate(instance.getNbJob(),sol,wct);
+    if (wct != elite[0].wct) {
+        cerr << "the stored value of " << storeFileName() << " is " << elite[0].wct << ", its solution is worth " << wct << endl;
+    }
+    found = true;
+    return true;
+}
+
+/**
+ * Add a solution of the global instance to the store, if it is among the store_elite best distinct ones
+ *
+ * The update is a read-modify-write under an exclusive lock (flock on <file>.lock), so concurrent runs, in this
+ * process or in others, never lose a solution; readers never see a partial file (see writeStore).
+ *
+ * @param[in] sol The solution
+ * @param[in] wct Its value
+ * @param[out] improved True if the solution is the new best known one, false otherwise
+ * @return false if one error occured, true otherwise
+ */
+bool storeUpdate(vector<int> & sol, int wct, bool & improved)
+{
+    improved = false;
+    if (mkdir(store_directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        generateError("store.h","storeUpdate","impossible to create the store","store",store_directory);
+        return false;
+    }
+    string fileName = storeFileName();
+    string lockName = fileName + ".lock";
+    int lockDescriptor = open(lockName.c_str(), O_RDWR | O_CREAT, 0644);
+    if (lockDescriptor < 0 || flock(lockDescriptor, LOCK_EX) != 0) {
+        generateError("store.h","storeUpdate","impossible to lock the store","file_name",lockName);
+        if (lockDescriptor >= 0) {
+            close(lockDescriptor);
+        }
+        return false;
+    }
+
+    vector<StoredSolution> elite;
+    bool ok = readStore(fileName,elite);
+    bool known = false;
+    for (StoredSolution & stored : elite) {
+        known = known || stored.sol == sol;
+    }
+    bool accepted = ok && !known && ((int)elite.size() < store_elite || wct < elite.back().wct);
+    if (accepted) {
+        improved = elite.empty() || wct < elite[0].wct;
+        elite.push_back({wct, sol});
+        sort(elite.begin(), elite.end(), [](const StoredSolution & a, const StoredSolution & b) { return a.wct < b.wct; });
+        if ((int)elite.size() > store_elite) {
+            elite.resize(store_elite);
+        }
+        ok = writeStore(fileName,elite);
+    }
+
+    flock(lockDescriptor, LOCK_UN);
+    close(lockDescriptor);
+    return ok;
+}
+
+/**
+ * Initial solution of the heuristics, improved by the VND : the supplied permutation (initial_solution_file, warm start),
+ * else the best known solution of the store (store_directory) if it has one, else simplifiedRZ
+ *
+ * @param[out] sol The solution
+ * @param[out] wct Its value
+ * @return false if one error occured, true otherwise
+ */
+bool initialSolution(vector<int> & sol, int & wct)
+{
+    if (!initial_solution_file.empty()) {
+        if (initial_solution_file == "-" && instance_file != NULL && string(instance_file) == "-") {
+            generateError("store.h","initialSolution","the instance and the initial solution can't both be read from the standard input");
+            return false;
+        }
+        if (!readPermutation(initial_solution_file,sol)) {
+            return false;
+        }
+        Objective::evaluate(instance.getNbJob(),sol,wct);
+        if (!quiet) {
+            cout << "initial solution from " << initial_solution_file << " : " << wct << endl;
+        }
+    } else {
+        bool found = false;
+        if (!store_directory.empty() && !storeLookup(sol,wct,found)) {
+            return false;
+        }
+        if (found) {
+            if (!quiet) {
+                cout << "initial solution from the store : " << wct << endl;
+            }
+        } else if (!simplifiedRZ(sol,wct)) {
+            return false;
+        }
+    }
+    return embeddedVND(sol,wct);
+}
+
+#endif
@@ -0,0 +1,110 @@
+/**********************************************************************
+ * Anytime trace : in-memory buffer of the improvements of a run      *
+ **********************************************************************/
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <fstream>
+#include <string>
+#include <functional>
+#include <climits>
+
+#include "globalVariables.h"
+#include "errors.h"
+#include "results.h"
+
+using namespace std;
+
+/// number of improvements kept : the TRACE_CAPACITY-1 first ones and the last one, the ones in between are dropped
+#define TRACE_CAPACITY 4096
+
+/// One improvement of the best solution of a run
+struct TraceEvent {
+    double time; /// ms since the start of the run
+    double evaluations; /// work units spent (see budget.h)
+    int iteration;
+    int wct;
+};
+
+thread_local TraceEvent traceEvents[TRACE_CAPACITY];
+thread_local long long nbTraceEvents = 0; /// number of improvements recorded since startTrace, may exceed TRACE_CAPACITY
+thread_local int traceTarget = INT_MIN; /// WCT whose time to reach is measured on the fly, set by the caller before the run
+thread_local double traceTargetTime = -1.; /// ms to reach traceTarget in the last run, -1 if not reached
+thread_local function<void(const TraceEvent &)> improvementListener; /// called on each improvement of the run if set (progress of the solver daemon, see serve.h)
+
+/**
+ * Forget the improvements of the previous run
+ */
+void startTrace()
+{
+    nbTraceEvents = 0;
+    traceTargetTime = -1.;
+}
+
+/**
+ * Number of improvements of the run kept in the buffer
+ *
+ * @return min(nbTraceEvents, TRACE_CAPACITY)
+ */
+long long nbKeptTraceEvents()
+{
+    return nbTraceEvents < TRACE_CAPACITY ? nbTraceEvents : TRACE_CAPACITY;
+}
+
+/**
+ * Record an improvement : a few stores in a preallocated buffer, no allocation nor output (besides the listener, if any)
+ * Once the buffer is full, the last slot holds the latest improvement, the time to traceTarget stays exact
+ * 
+ * @param[in] time ms since the start of the run
+ * @param[in] iteration Current iteration
+ * @param[in] wct The new best WCT
+ */
+void recordImprovement(double time, int iteration, int wct)
+{
+    TraceEvent & event = traceEvents[nbTraceEvents < TRACE_CAPACITY ? nbTraceEvents : TRACE_CAPACITY-1];
+    event.time = time;
+    event.evaluations = instance.getNbEvaluations();
+    event.iteration = iteration;
+    event.wct = wct;
+    nbTraceEvents ++;
+    if (traceTargetTime < 0 && wct <= traceTarget) {
+        traceTargetTime = time;
+    }
+    if (improvementListener) {
+        improvementListener(event);
+    }
+}
+
+/**
+ * Append the improvements of the last run to the trace file, oldest first, with a CSV header if the file is new
+ * If some improvements were dropped (buffer full), a "trace truncated" line counts them before the last one
+ * 
+ * @param[in] fileName Name of the trace file
+ * @param[in] instanceName Name of the instance of the run
+ * @return false if one error occured, true otherwise
+ */
+bool writeTrace(string fileName, string instanceName)
+{
+    ofstream traceStream(fileName, ios::app);
+    if (!traceStream) {
+        generateError("trace.h","writeTrace","impossible to open a file","file_name",fileName);
+        return false;
+    }
+    traceStream.seekp(0, ios::end);
+    if (traceStream.tellp() == 0) {
+        traceStream << "instance,algorithm,seed,time_ms,evaluations,iteration,wct\n";
+    }
+
+    for (long long k = 0; k < nbKeptTraceEvents(); k++) {
+        TraceEvent & event = traceEvents[k];
+        if (k == TRACE_CAPACITY-1 && nbTraceEvents > TRACE_CAPACITY) {
+            traceStream << "# trace truncated : " << nbTraceEvents - TRACE_CAPACITY << " improvements dropped\n";
+        }
+        traceStream << csvField(instanceName) << "," << sls_global << "," << seed << "," << event.time << ","
+                    << event.evaluations << "," << event.iteration << "," << event.wct << "\n";
+    }
+    return true;
+}
+
+#endif